@@ -0,0 +1,195 @@
+"""Compile-time benchmark for the sfn type_list and functional operators.
+
+Generates one translation unit per (operator, size) case, compiles each with the chosen compiler,
+and reports wall-clock compile time, peak compiler RSS and object file size as JSON lines:
+
+  bazel run //:compile_time_benchmark -- --cxx=clang++ --sizes=16,64,256
+"""
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import tempfile
+import time
+
+PRELUDE = """\
+#include <sfn/functional.h>
+#include <cstddef>
+#include <utility>
+
+template <std::size_t N>
+struct E {};
+template <std::size_t... Ns>
+constexpr auto make_list_impl(std::index_sequence<Ns...>) -> sfn::list<E<Ns>...>;
+template <std::size_t N>
+using make_list = decltype(make_list_impl(std::make_index_sequence<N>{}));
+template <typename T>
+struct next;
+template <std::size_t N>
+struct next<E<N>> {
+  using type = E<N + 1>;
+};
+template <typename T>
+struct is_even;
+template <std::size_t N>
+struct is_even<E<N>> {
+  static constexpr bool value = N % 2 == 0;
+};
+template <typename T>
+void use(T) {}
+"""
+
+
+def params(n, type_name="int"):
+    return ", ".join(f"{type_name} a{i}" for i in range(n))
+
+
+def types(n, type_name="int"):
+    return ", ".join([type_name] * n)
+
+
+def sum_body(n):
+    return " + ".join(f"a{i}" for i in range(n)) if n else "0"
+
+
+def gen_concat(n):
+    return f"using result = sfn::concat<make_list<{n}>, make_list<{n}>>;\n" \
+        f"static_assert(sfn::size<result> == {2 * n});\n"
+
+
+def gen_get(n):
+    return f"using l = make_list<{n}>;\n" + "".join(
+        f"static_assert(sizeof(sfn::get<l, {i}>*) != 0);\n" for i in range(0, n, max(1, n // 16)))
+
+
+def gen_sublist(n):
+    return f"using l = make_list<{n}>;\n" + "".join(
+        f"static_assert(sfn::size<sfn::sublist<l, {i}, {n // 2}>> <= {n // 2});\n"
+        for i in range(0, n, max(1, n // 16)))
+
+
+def gen_filter(n):
+    return f"static_assert(sfn::size<sfn::filter<make_list<{n}>, is_even>> == {(n + 1) // 2});\n"
+
+
+def gen_map(n):
+    return f"static_assert(sfn::size<sfn::map<make_list<{n}>, next>> == {n});\n"
+
+
+def gen_cast(n):
+    return f"int f({params(n)}) {{ return {sum_body(n)}; }}\n" \
+        f"sfn::ptr<long({types(n, 'long')})> result = sfn::cast<long({types(n, 'long')}), &f>;\n" \
+        f"sfn::ptr<void({types(n + 1, 'short')})> wider = " \
+        f"sfn::cast<void({types(n + 1, 'short')}), &f>;\n"
+
+
+def gen_bind_front(n):
+    values = ", ".join(str(i) for i in range(n // 2))
+    return f"int f({params(n)}) {{ return {sum_body(n)}; }}\n" \
+        f"auto* result = sfn::bind_front<&f, {values}>;\n"
+
+
+def gen_compose_front(n):
+    return f"int f({params(n)}) {{ return {sum_body(n)}; }}\n" \
+        f"int g({params(n)}) {{ return {sum_body(n)}; }}\n" \
+        f"auto* result = sfn::compose_front<&g, &f>;\n"
+
+
+def gen_pipeline(n):
+    functions = "".join(f"int f{i}(int x) {{ return x + {i}; }}\n" for i in range(n))
+    pointers = ", ".join(f"&f{i}" for i in range(n))
+    return functions + f"auto* result = sfn::pipeline<{pointers}>;\n"
+
+
+def gen_nested_compose(n):
+    functions = "".join(f"int f{i}(int x) {{ return x + {i}; }}\n" for i in range(n))
+    expression = "&f0"
+    for i in range(1, n):
+        expression = f"sfn::compose<&f{i}, {expression}>"
+    return functions + f"auto* result = {expression};\n"
+
+
+def gen_sequence(n):
+    functions = "".join(f"int f{i}(int x, int y) {{ return x + y + {i}; }}\n" for i in range(n))
+    pointers = ", ".join(f"&f{i}" for i in range(n))
+    return functions + f"auto* result = sfn::sequence<{pointers}>;\n"
+
+
+def gen_type_switch(n):
+    return "template <typename T>\n" \
+        "struct handler {\n" \
+        "  static int f(int x) { return x + static_cast<int>(sizeof(T)); }\n" \
+        "};\n" \
+        f"auto* result = sfn::type_switch<make_list<{n}>, handler>;\n"
+
+
+OPERATORS = {
+    "concat": gen_concat,
+    "get": gen_get,
+    "sublist": gen_sublist,
+    "filter": gen_filter,
+    "map": gen_map,
+    "cast": gen_cast,
+    "bind_front": gen_bind_front,
+    "compose_front": gen_compose_front,
+    "pipeline": gen_pipeline,
+    "nested_compose": gen_nested_compose,
+    "sequence": gen_sequence,
+    "type_switch": gen_type_switch,
+}
+
+
+def compile_case(args, include_dir, source):
+    with tempfile.TemporaryDirectory() as tmp:
+        src = os.path.join(tmp, "case.cc")
+        obj = os.path.join(tmp, "case.o")
+        with open(src, "w") as f:
+            f.write(source)
+        command = [args.cxx, "-std=c++20", "-I" + include_dir, "-c", src, "-o", obj] + args.copt
+        # Diagnostics go to a file rather than a pipe: a compiler that writes more than the pipe
+        # buffer would otherwise block forever while we wait for it to exit.
+        with tempfile.TemporaryFile() as errors:
+            start = time.perf_counter()
+            process = subprocess.Popen(command, stderr=errors)
+            _, status, usage = os.wait4(process.pid, 0)
+            wall = time.perf_counter() - start
+            errors.seek(0)
+            stderr = errors.read().decode(errors="replace")
+        if os.waitstatus_to_exitcode(status) != 0:
+            return {"error": stderr.strip()[:2000]}
+        # ru_maxrss is in kilobytes on Linux, bytes on macOS.
+        rss_kb = usage.ru_maxrss // 1024 if sys.platform == "darwin" else usage.ru_maxrss
+        return {
+            "wall_seconds": round(wall, 4),
+            "peak_rss_kb": rss_kb,
+            "object_bytes": os.path.getsize(obj),
+        }
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--cxx", default=os.environ.get("CXX", "c++"))
+    parser.add_argument("--copt", action="append", default=[], help="extra compiler flag")
+    parser.add_argument("--sizes", default="8,32,128,512")
+    parser.add_argument("--operators", default=",".join(OPERATORS))
+    parser.add_argument("--output", help="write JSON lines here instead of stdout")
+    args = parser.parse_args()
+
+    include_dir = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "include")
+    output = open(args.output, "w") if args.output else sys.stdout
+    failed = False
+    for name in args.operators.split(","):
+        for n in [int(s) for s in args.sizes.split(",")]:
+            result = {"operator": name, "size": n, "cxx": args.cxx}
+            result.update(compile_case(args, include_dir, PRELUDE + OPERATORS[name](n)))
+            failed = failed or "error" in result
+            output.write(json.dumps(result) + "\n")
+            output.flush()
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,427 @@
+// Compares per-call cost of sfn wrappers with equivalent lambdas, std::function and hand-written
+// code. Prints one JSON object per case. Built at several optimization levels, e.g.
+//   bazel run //:runtime_benchmark_O2
+#include <sfn/functional.h>
+#include <sfn/handle.h>
+#include <sfn/slot.h>
+#include <sfn/string_dispatch.h>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+template <typename T>
+inline void do_not_optimize(T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : "+m"(value) : : "memory");
+#else
+  static volatile T* sink;
+  sink = &value;
+#endif
+}
+
+#ifndef SFN_BENCHMARK_OPT
+#define SFN_BENCHMARK_OPT unknown
+#endif
+#define SFN_BENCHMARK_STRINGIZE_IMPL(x) #x
+#define SFN_BENCHMARK_STRINGIZE(x) SFN_BENCHMARK_STRINGIZE_IMPL(x)
+
+inline constexpr std::size_t kIterations = 1u << 24;
+
+template <typename Body>
+void run(const char* group, const char* name, Body body) {
+  for (std::size_t i = 0; i < kIterations / 16; ++i) {
+    body(i);
+  }
+  auto start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < kIterations; ++i) {
+    body(i);
+  }
+  auto end = std::chrono::steady_clock::now();
+  double ns = std::chrono::duration<double, std::nano>(end - start).count();
+  std::printf(
+      "{\"opt\": \"%s\", \"group\": \"%s\", \"case\": \"%s\", \"ns_per_call\": %.3f}\n",
+      SFN_BENCHMARK_STRINGIZE(SFN_BENCHMARK_OPT), group, name, ns / kIterations);
+}
+
+// Runs the same call through a constant sfn pointer, a runtime (opaque) copy of that pointer,
+// the equivalent lambda, std::function, and a direct call of the hand-written equivalent.
+template <auto Sfn, typename Lambda, typename Direct, typename Arg>
+void compare(const char* group, Lambda lambda, Direct direct, Arg make_arg) {
+  auto opaque = Sfn;
+  do_not_optimize(opaque);
+  std::function function = lambda;
+  run(group, "sfn", [&](std::size_t i) {
+    auto r = Sfn(make_arg(i));
+    do_not_optimize(r);
+  });
+  run(group, "sfn_indirect", [&](std::size_t i) {
+    auto r = opaque(make_arg(i));
+    do_not_optimize(r);
+  });
+  run(group, "lambda", [&](std::size_t i) {
+    auto r = lambda(make_arg(i));
+    do_not_optimize(r);
+  });
+  run(group, "std_function", [&](std::size_t i) {
+    auto r = function(make_arg(i));
+    do_not_optimize(r);
+  });
+  run(group, "direct", [&](std::size_t i) {
+    auto r = direct(make_arg(i));
+    do_not_optimize(r);
+  });
+}
+
+int add_one(int x) {
+  return x + 1;
+}
+int square(int x) {
+  return x * x;
+}
+int subtract(int x, int y) {
+  return x - y;
+}
+
+struct Counter {
+  int value = 0;
+  int next() {
+    return ++value;
+  }
+};
+
+struct Large {
+  std::int64_t values[32];
+};
+std::int64_t sum_large(Large large) {
+  std::int64_t result = 0;
+  for (auto v : large.values) {
+    result += v;
+  }
+  return result;
+}
+Large make_large(int x) {
+  Large large{};
+  large.values[x & 31] = x;
+  return large;
+}
+
+std::int64_t negate(std::int64_t x) {
+  return -x;
+}
+
+int read_unique(std::unique_ptr<int> p) {
+  return *p;
+}
+std::unique_ptr<int> make_unique_int(int x) {
+  return std::make_unique<int>(x);
+}
+
+// Counts moves, to show how many times a by-value argument is moved on its way through a chain of
+// wrappers: once with STATIC_FUNCTIONAL_FUSION_REGISTRY, since the layers pass it down by
+// reference, and otherwise once per layer.
+struct Tracked {
+  explicit Tracked(int v) : value{v} {}
+  Tracked(Tracked&& other) noexcept : value{other.value} {
+    ++moves;
+  }
+  int value;
+  static inline std::size_t moves = 0;
+};
+int read_tracked(Tracked t, int y) {
+  return t.value + y;
+}
+
+// A chain mixing several operators, for checking that the layers fuse into one function.
+inline constexpr auto mixed =
+    sfn::compose<&square, sfn::cast<long(Tracked), sfn::bind_back<&read_tracked, 3>>>;
+long mixed_direct(Tracked t) {
+  return square(static_cast<int>(static_cast<long>(read_tracked(std::move(t), 3))));
+}
+
+template <auto Sfn, typename Lambda>
+void count_moves(const char* group, Lambda lambda) {
+  auto print = [&](const char* name, auto f) {
+    Tracked::moves = 0;
+    f(Tracked{1});
+    std::printf(
+        "{\"opt\": \"%s\", \"group\": \"%s\", \"case\": \"%s\", \"moves_per_call\": %zu}\n",
+        SFN_BENCHMARK_STRINGIZE(SFN_BENCHMARK_OPT), group, name, Tracked::moves);
+  };
+  print("sfn", Sfn);
+  print("lambda", lambda);
+}
+
+// Calls a C-style callback through an opaque pointer, as a C library would.
+struct Widget {
+  int offset = 3;
+  int handle(int x) {
+    return x + offset;
+  }
+};
+int widget_trampoline(void* userdata, int x) {
+  return static_cast<Widget*>(userdata)->handle(x);
+}
+int function_trampoline(void* userdata, int x) {
+  return (*static_cast<std::function<int(int)>*>(userdata))(x);
+}
+
+void compare_c_callback() {
+  Widget widget;
+  auto function = std::make_unique<std::function<int(int)>>(
+      [&widget](int x) { return widget.handle(x); });
+  auto call = [](const char* name, int (*callback)(void*, int), void* userdata) {
+    do_not_optimize(callback);
+    do_not_optimize(userdata);
+    run("c_callback", name, [&](std::size_t i) {
+      auto r = callback(userdata, static_cast<int>(i));
+      do_not_optimize(r);
+    });
+  };
+  call("sfn", sfn::c_callback<&Widget::handle>, &widget);
+  call("hand_written", &widget_trampoline, &widget);
+  call("std_function", &function_trampoline, function.get());
+}
+
+// A kernel whose loop can be unrolled and vectorized when the stride is a compile-time constant.
+int strided_data[256];
+int strided_sum(int stride, int scale) {
+  int sum = 0;
+  for (int i = 0; i < 256; i += stride) {
+    sum += strided_data[i] * scale;
+  }
+  return sum;
+}
+template <int Stride>
+int strided_sum_fixed(int scale) {
+  return strided_sum(Stride, scale);
+}
+int strided_sum_switch(int stride, int scale) {
+  switch (stride) {
+  case 1:
+    return strided_sum_fixed<1>(scale);
+  case 2:
+    return strided_sum_fixed<2>(scale);
+  case 4:
+    return strided_sum_fixed<4>(scale);
+  default:
+    return strided_sum(stride, scale);
+  }
+}
+
+void compare_specialize() {
+  for (int i = 0; i < 256; ++i) {
+    strided_data[i] = i;
+  }
+  do_not_optimize(strided_data);
+  auto call = [](const char* name, int (*f)(int, int)) {
+    do_not_optimize(f);
+    run("specialize", name, [&](std::size_t i) {
+      auto r = f(1 << (i % 3u), static_cast<int>(i));
+      do_not_optimize(r);
+    });
+  };
+  call("sfn", sfn::specialize<&strided_sum, 0u, 1, 2, 4>);
+  call("switch", &strided_sum_switch);
+  call("generic", &strided_sum);
+}
+
+// Looks up a handler by method name, as an RPC server would.
+const std::string_view rpc_methods[] = {"get", "put", "erase", "list", "watch", "missing"};
+int rpc_unknown(std::string_view, int) {
+  return -1;
+}
+
+void compare_string_dispatch() {
+  auto sfn_dispatch =
+      sfn::string_dispatch_or<&rpc_unknown, sfn::entry<"get", &add_one>,
+                              sfn::entry<"put", &square>, sfn::entry<"erase", &add_one>,
+                              sfn::entry<"list", &square>, sfn::entry<"watch", &add_one>>;
+  std::unordered_map<std::string, std::function<int(int)>> map = {
+      {"get", &add_one}, {"put", &square}, {"erase", &add_one}, {"list", &square},
+      {"watch", &add_one}};
+  auto map_dispatch = [&map](std::string_view method, int x) {
+    auto it = map.find(std::string{method});
+    return it == map.end() ? rpc_unknown(method, x) : it->second(x);
+  };
+  do_not_optimize(sfn_dispatch);
+  run("string_dispatch", "sfn", [&](std::size_t i) {
+    auto r = sfn_dispatch(rpc_methods[i % 6u], static_cast<int>(i));
+    do_not_optimize(r);
+  });
+  run("string_dispatch", "unordered_map", [&](std::size_t i) {
+    auto r = map_dispatch(rpc_methods[i % 6u], static_cast<int>(i));
+    do_not_optimize(r);
+  });
+}
+
+// Drains a queue of a million pending callbacks, stored as a function pointer and a userdata
+// pointer or as a 16-bit handle and a 32-bit argument.
+inline constexpr std::size_t kQueueSize = 1u << 20;
+std::uint32_t handler_state[4];
+void handle_add(std::uint32_t x) {
+  handler_state[0] += x;
+}
+void handle_xor(std::uint32_t x) {
+  handler_state[1] ^= x;
+}
+void handle_max(std::uint32_t x) {
+  handler_state[2] = handler_state[2] > x ? handler_state[2] : x;
+}
+void handle_count(std::uint32_t) {
+  ++handler_state[3];
+}
+template <void (*F)(std::uint32_t)>
+void handle_userdata(void* userdata) {
+  F(static_cast<std::uint32_t>(reinterpret_cast<std::uintptr_t>(userdata)));
+}
+
+void compare_handle() {
+  using event_handle = sfn::handle<void(std::uint32_t), std::uint16_t>;
+  struct pointer_event {
+    void (*callback)(void*);
+    void* userdata;
+  };
+  struct handle_event {
+    event_handle callback;
+    std::uint32_t argument;
+  };
+  const event_handle handles[] = {event_handle::of<&handle_add>(), event_handle::of<&handle_xor>(),
+                                  event_handle::of<&handle_max>(),
+                                  event_handle::of<&handle_count>()};
+  void (*const pointers[])(void*) = {
+      &handle_userdata<&handle_add>, &handle_userdata<&handle_xor>, &handle_userdata<&handle_max>,
+      &handle_userdata<&handle_count>};
+  std::vector<pointer_event> pointer_queue;
+  std::vector<handle_event> handle_queue;
+  for (std::size_t i = 0; i < kQueueSize; ++i) {
+    auto k = (i * 2654435761u) >> 7;
+    auto argument = static_cast<std::uint32_t>(i);
+    pointer_queue.push_back({pointers[k % 4u], reinterpret_cast<void*>(std::uintptr_t{argument})});
+    handle_queue.push_back({handles[k % 4u], argument});
+  }
+  auto print = [](const char* name, std::size_t bytes) {
+    std::printf(
+        "{\"opt\": \"%s\", \"group\": \"handle\", \"case\": \"%s\", "
+        "\"bytes_per_entry\": %zu}\n",
+        SFN_BENCHMARK_STRINGIZE(SFN_BENCHMARK_OPT), name, bytes);
+  };
+  run("handle", "sfn", [&](std::size_t i) {
+    const auto& e = handle_queue[i % kQueueSize];
+    e.callback(e.argument);
+  });
+  run("handle", "function_pointer", [&](std::size_t i) {
+    const auto& e = pointer_queue[i % kQueueSize];
+    e.callback(e.userdata);
+  });
+  print("sfn", sizeof(handle_event));
+  print("function_pointer", sizeof(pointer_event));
+  do_not_optimize(handler_state);
+}
+
+// A hot-swappable function pointer, called while no swap is in progress.
+struct BenchmarkSlot {};
+using benchmark_slot = sfn::slot<int(int), BenchmarkSlot>;
+
+// A small-domain function which is expensive to compute directly.
+constexpr int collatz_steps(std::uint8_t x) {
+  int steps = 0;
+  for (std::uint32_t n = x; n > 1u; ++steps) {
+    n = n % 2u ? 3u * n + 1u : n / 2u;
+  }
+  return steps;
+}
+
+template <std::size_t N>
+struct nested {
+  static constexpr auto value = sfn::compose<&add_one, nested<N - 1>::value>;
+};
+template <>
+struct nested<1> {
+  static constexpr auto value = &add_one;
+};
+
+template <std::size_t N>
+void compare_nested(const char* group) {
+  compare<nested<N>::value>(
+      group, [](int x) { return x + static_cast<int>(N); },
+      [](int x) {
+        for (std::size_t i = 0; i < N; ++i) {
+          x = add_one(x);
+        }
+        return x;
+      },
+      [](std::size_t i) { return static_cast<int>(i); });
+}
+
+}  // namespace
+
+int main() {
+  auto int_arg = [](std::size_t i) { return static_cast<int>(i); };
+
+  compare<sfn::compose<&square, &add_one>>(
+      "compose", [](int x) { return square(add_one(x)); },
+      [](int x) { return square(add_one(x)); }, int_arg);
+  compare<sfn::bind_front<&subtract, 3>>(
+      "bind_front", [](int x) { return subtract(3, x); }, [](int x) { return subtract(3, x); },
+      int_arg);
+  compare<sfn::bind_back<&subtract, 3>>(
+      "bind_back", [](int x) { return subtract(x, 3); }, [](int x) { return subtract(x, 3); },
+      int_arg);
+  compare<sfn::cast<long(short), &add_one>>(
+      "cast", [](short x) { return static_cast<long>(add_one(x)); },
+      [](short x) { return static_cast<long>(add_one(x)); },
+      [](std::size_t i) { return static_cast<short>(i); });
+  compare<sfn::sequence<&add_one, &square>>(
+      "sequence", [](int x) { return add_one(x), square(x); },
+      [](int x) { return add_one(x), square(x); }, int_arg);
+
+  Counter counter;
+  compare<sfn::unwrap<&Counter::next>>(
+      "unwrap", [](Counter& c) { return c.next(); }, [](Counter& c) { return c.next(); },
+      [&](std::size_t) -> Counter& { return counter; });
+
+  compare<sfn::compose<&sum_large, &make_large>>(
+      "large_by_value", [](int x) { return sum_large(make_large(x)); },
+      [](int x) { return sum_large(make_large(x)); }, int_arg);
+  compare<sfn::compose<&negate, &sum_large>>(
+      "large_parameter", [](Large x) { return negate(sum_large(x)); },
+      [](Large x) { return negate(sum_large(x)); },
+      [](std::size_t i) { return make_large(static_cast<int>(i)); });
+  compare<sfn::compose<&read_unique, &make_unique_int>>(
+      "move_only", [](int x) { return read_unique(make_unique_int(x)); },
+      [](int x) { return read_unique(make_unique_int(x)); }, int_arg);
+
+  compare_c_callback();
+  compare_specialize();
+  compare_string_dispatch();
+  compare_handle();
+  (void)benchmark_slot::swap<&add_one>();
+  compare<benchmark_slot::call>(
+      "slot", [](int x) { return add_one(x); }, &add_one, int_arg);
+  compare<sfn::tabulate<&collatz_steps, 0, 255>>(
+      "tabulate", [](std::uint8_t x) { return collatz_steps(x); }, &collatz_steps,
+      [](std::size_t i) { return static_cast<std::uint8_t>(i * 37u); });
+
+  compare_nested<1>("nested_1");
+  compare_nested<2>("nested_2");
+  compare_nested<4>("nested_4");
+  compare_nested<8>("nested_8");
+  compare_nested<16>("nested_16");
+
+  auto mixed_lambda = [](Tracked t) {
+    return square(static_cast<int>(static_cast<long>(read_tracked(std::move(t), 3))));
+  };
+  compare<mixed>("mixed", mixed_lambda, &mixed_direct,
+                 [](std::size_t i) { return Tracked{static_cast<int>(i)}; });
+  count_moves<mixed>("mixed", mixed_lambda);
+  return 0;
+}
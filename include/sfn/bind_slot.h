@@ -0,0 +1,100 @@
+#ifndef STATIC_FUNCTIONAL_INCLUDE_SFN_BIND_SLOT_H
+#define STATIC_FUNCTIONAL_INCLUDE_SFN_BIND_SLOT_H
+#include <sfn/functional.h>
+#include <atomic>
+#include <type_traits>
+
+namespace sfn {
+//-------------------------------------------------------------------------------------------------
+// bind_slot
+//-------------------------------------------------------------------------------------------------
+// A bind slot tag names a runtime value of type Tag::type which can be bound to function
+// parameters. Values are stored in lock-free atomics, so larger configuration should be bound via a
+// pointer. (Unrelated to sfn::slot, which holds a swappable function pointer.)
+template <typename T>
+concept bind_slot_tag = requires {
+  typename T::type;
+} && std::is_trivially_copyable_v<typename T::type> &&
+    std::atomic<typename T::type>::is_always_lock_free;
+
+namespace detail {
+template <bind_slot_tag Tag>
+constexpr bool bind_slot_thread_local() {
+  if constexpr (requires { bool{Tag::thread_local_slot}; }) {
+    return Tag::thread_local_slot;
+  } else {
+    return false;
+  }
+}
+
+// Global slots are read with a single acquire load (a plain load on x86 and ARM64), which pairs
+// with the release store in bind_slot_store: anything written before rebinding the slot is visible
+// to calls that see the new value.
+template <bind_slot_tag Tag, bool ThreadLocal = bind_slot_thread_local<Tag>()>
+struct bind_slot_storage {
+  using type = typename Tag::type;
+  static type load() noexcept {
+    return value.load(std::memory_order_acquire);
+  }
+  static void store(type v) noexcept {
+    value.store(v, std::memory_order_release);
+  }
+  inline static constinit std::atomic<type> value{};
+};
+template <bind_slot_tag Tag>
+struct bind_slot_storage<Tag, true> {
+  using type = typename Tag::type;
+  static type load() noexcept {
+    return value;
+  }
+  static void store(type v) noexcept {
+    value = v;
+  }
+  inline static constinit thread_local type value{};
+};
+
+// Bound in place of a value by bind_front and bind_back, and converted to the bound parameter type
+// by reading the slot on each call.
+template <bind_slot_tag Tag>
+struct bind_slot_value {
+  operator typename Tag::type() const noexcept {
+    return bind_slot_storage<Tag>::load();
+  }
+};
+}  // namespace detail
+
+template <typename F, typename... Tags>
+concept bind_slot_bindable_front =
+    (bind_slot_tag<Tags> && ...) && bindable_front<F, detail::bind_slot_value<Tags>...>;
+
+template <typename F, typename... Tags>
+concept bind_slot_bindable_back =
+    (bind_slot_tag<Tags> && ...) && bindable_back<F, detail::bind_slot_value<Tags>...>;
+
+template <function auto F, typename... Tags>
+requires bind_slot_bindable_front<decltype(F), Tags...>
+inline constexpr auto bind_slot_front = bind_front<F, detail::bind_slot_value<Tags>{}...>;
+
+template <function auto F, typename... Tags>
+requires bind_slot_bindable_back<decltype(F), Tags...>
+inline constexpr auto bind_slot_back = bind_back<F, detail::bind_slot_value<Tags>{}...>;
+
+template <function auto F, typename... Tags>
+requires bind_slot_bindable_front<decltype(F), Tags...>
+inline constexpr auto bind_slot = bind_slot_front<F, Tags...>;
+
+// Sets the value bound by every function using the slot (or the calling thread's slot, if Tag is
+// thread-local). Slots hold a value-initialized Tag::type until they are first set.
+template <bind_slot_tag Tag>
+inline void bind_slot_store(typename Tag::type value) noexcept {
+  detail::bind_slot_storage<Tag>::store(value);
+}
+
+template <bind_slot_tag Tag>
+inline typename Tag::type bind_slot_load() noexcept {
+  return detail::bind_slot_storage<Tag>::load();
+}
+
+}  // namespace sfn
+
+#endif
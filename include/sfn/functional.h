@@ -1,9 +1,38 @@
 #ifndef STATIC_FUNCTIONAL_INCLUDE_SFN_FUNCTIONAL_H
 #define STATIC_FUNCTIONAL_INCLUDE_SFN_FUNCTIONAL_H
 #include <sfn/type_list.h>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
 #include <type_traits>
 #include <utility>
 
+// Nested operators are fused: the wrappers generated for a nested chain of operators (e.g.
+// compose<h, compose<g, bind_back<&f, 3>>>) are force-inlined into each other, so that the chain
+// compiles to a single function which calls the original functions directly, even in unoptimized
+// builds. Define STATIC_FUNCTIONAL_NO_FUSION to keep one function and stack frame per layer
+// instead.
+#if defined(STATIC_FUNCTIONAL_NO_FUSION)
+#define STATIC_FUNCTIONAL_FUSE
+#elif defined(__GNUC__) || defined(__clang__)
+#define STATIC_FUNCTIONAL_FUSE [[gnu::always_inline]]
+#elif defined(_MSC_VER)
+#define STATIC_FUNCTIONAL_FUSE [[msvc::forceinline]]
+#else
+#define STATIC_FUNCTIONAL_FUSE
+#endif
+
+// With STATIC_FUNCTIONAL_FUSION_REGISTRY, fused wrappers also pass their arguments down to the
+// original functions by reference, so that each argument is moved once rather than once per layer.
+// This finds a wrapper from the address of its function through friend functions which are defined
+// when the wrapper is instantiated, which is only enabled by default on compilers it has been
+// verified with (GCC); define it to enable it elsewhere.
+#if defined(STATIC_FUNCTIONAL_NO_FUSION)
+#undef STATIC_FUNCTIONAL_FUSION_REGISTRY
+#elif defined(__GNUC__) && !defined(__clang__) && !defined(STATIC_FUNCTIONAL_FUSION_REGISTRY)
+#define STATIC_FUNCTIONAL_FUSION_REGISTRY
+#endif
+
 namespace sfn {
 //-------------------------------------------------------------------------------------------------
 // function_traits
@@ -108,27 +137,114 @@ template <functional T>
 inline constexpr bool is_noexcept = function_traits<T>::is_noexcept;
 
 //-------------------------------------------------------------------------------------------------
-// unwrap
+// fusion
 //-------------------------------------------------------------------------------------------------
 namespace detail {
 template <typename T>
 inline constexpr bool should_move = std::is_move_constructible_v<std::remove_cvref_t<T>> &&
     !std::is_const_v<std::remove_reference_t<T>> && !std::is_lvalue_reference_v<T>;
 template <typename T>
-constexpr decltype(auto) maybe_move(typename std::remove_reference_t<T>& v) noexcept {
+STATIC_FUNCTIONAL_FUSE constexpr decltype(auto)
+maybe_move(typename std::remove_reference_t<T>& v) noexcept {
   if constexpr (should_move<T>) {
-    return std::move(v);
+    return static_cast<std::remove_reference_t<T>&&>(v);
   } else {
     return v;
   }
 }
 
+// Besides f, each fusable wrapper W has a function W::call taking references to objects of f's
+// parameter types, which it moves from only where f would move from its parameters. An operator
+// whose input is such a wrapper calls its call() instead of f, so that arguments are passed down a
+// nested chain by reference and moved once, into the original function.
+//
+// The address of a static member function doesn't identify its class (it isn't deducible), so
+// fused_f<W> registers W under the address of W::f: instantiating fused_entry defines the friend
+// function declared by fused_key<&W::f>, whose return type is then looked up by fused_t. Without
+// the registry, fused_f<W> is just &W::f and nothing is fused.
+#ifdef STATIC_FUNCTIONAL_FUSION_REGISTRY
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wnon-template-friend"
+#endif
+template <auto F>
+struct fused_key {
+  friend constexpr auto fused_lookup(fused_key);
+};
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+template <auto F, typename Wrapper>
+struct fused_entry {
+  friend constexpr auto fused_lookup(fused_key<F>) {
+    return static_cast<Wrapper*>(nullptr);
+  }
+};
+
+template <typename Wrapper>
+inline constexpr auto fused_f =
+    (void(sizeof(fused_entry<&Wrapper::f, Wrapper>)), &Wrapper::f);
+template <auto F>
+inline constexpr bool is_fused = requires { fused_lookup(fused_key<F>{}); };
+template <auto F>
+using fused_t = std::remove_pointer_t<decltype(fused_lookup(fused_key<F>{}))>;
+#else
+template <typename Wrapper>
+inline constexpr auto fused_f = &Wrapper::f;
+template <auto F>
+inline constexpr bool is_fused = false;
+// Only named in discarded branches.
+template <auto F>
+struct fused_unavailable;
+template <auto F>
+using fused_t = fused_unavailable<F>;
+#endif
+
+// Passes a temporary to a call() parameter; it lives until the end of the full-expression.
+template <typename T>
+STATIC_FUNCTIONAL_FUSE constexpr T& as_lvalue(T&& v) noexcept {
+  return v;
+}
+
+// Calls F with objects of its own parameter types, which it may move from.
+template <function auto F, typename... Args>
+STATIC_FUNCTIONAL_FUSE constexpr decltype(auto) fused_call(std::remove_reference_t<Args>&... args) {
+  if constexpr (is_fused<F>) {
+    return fused_t<F>::call(args...);
+  } else {
+    return F(maybe_move<Args>(args)...);
+  }
+}
+
+// Argument for a call() parameter of type To, from an object declared with type From: the object
+// itself if the types are the same, otherwise a converted temporary. Conversions to a different
+// reference type aren't fused, since the temporary they may bind to can't be returned.
+template <typename To, typename From>
+inline constexpr bool fusable_arg = std::is_same_v<To, From> || !std::is_reference_v<To>;
+template <typename To, typename From>
+STATIC_FUNCTIONAL_FUSE constexpr decltype(auto) fused_arg(std::remove_reference_t<From>& v) {
+  if constexpr (std::is_same_v<To, From>) {
+    return (v);
+  } else {
+    return To(maybe_move<From>(v));
+  }
+}
+}  // namespace detail
+
+//-------------------------------------------------------------------------------------------------
+// unwrap
+//-------------------------------------------------------------------------------------------------
+namespace detail {
 template <member_function auto F, typename, type_list>
 struct unwrap_f;
 template <member_function auto F, typename C, typename... Args>
 struct unwrap_f<F, C, list<Args...>> {
-  static inline constexpr decltype(auto)
+  STATIC_FUNCTIONAL_FUSE static inline constexpr decltype(auto)
   f(C c, Args... args) noexcept(noexcept((maybe_move<C>(c).*F)(maybe_move<Args>(args)...))) {
+    return call(c, args...);
+  }
+  STATIC_FUNCTIONAL_FUSE static inline constexpr decltype(auto)
+  call(std::remove_reference_t<C>& c, std::remove_reference_t<Args>&... args) {
     return (maybe_move<C>(c).*F)(maybe_move<Args>(args)...);
   }
 };
@@ -140,7 +256,7 @@ template <function auto F>
 struct unwrap_if<F, true> {
   using parameter_types = parameter_types_of<decltype(F)>;
   static inline constexpr auto value =
-      &unwrap_f<F, front<parameter_types>, sublist<parameter_types, 1>>::f;
+      fused_f<unwrap_f<F, front<parameter_types>, sublist<parameter_types, 1>>>;
 };
 }  // namespace detail
 
@@ -155,7 +271,13 @@ template <typename, function auto... F>
 struct sequence_f;
 template <typename... Args, function auto... F>
 struct sequence_f<list<Args...>, F...> {
-  inline static constexpr decltype(auto) f(Args... args) noexcept(noexcept((F(args...), ...))) {
+  STATIC_FUNCTIONAL_FUSE inline static constexpr decltype(auto)
+  f(Args... args) noexcept(noexcept((F(args...), ...))) {
+    return call(args...);
+  }
+  // Every function gets its own copy of each argument, so these are never moved from.
+  STATIC_FUNCTIONAL_FUSE inline static constexpr decltype(auto)
+  call(std::remove_reference_t<Args>&... args) {
     return (F(args...), ...);
   }
 };
@@ -170,8 +292,8 @@ concept sequencable = functional<T> &&(functional<Rest>&&...) &&
 
 template <function auto F, function auto... Rest>
 requires sequencable<decltype(F), decltype(Rest)...>
-inline constexpr auto sequence =
-    &detail::sequence_f<parameter_types_of<decltype(F)>, unwrap<F>, unwrap<Rest>...>::f;
+inline constexpr auto sequence = detail::fused_f<
+    detail::sequence_f<parameter_types_of<decltype(F)>, unwrap<F>, unwrap<Rest>...>>;
 
 template <function auto F>
 requires sequencable<decltype(F)>
@@ -195,10 +317,21 @@ template <function auto F, bool CastToNoExcept, typename R, typename... UsedSour
           typename... UnusedSourceArgs, typename... UsedTargetArgs, typename... UnusedTargetArgs>
 struct cast_f<F, CastToNoExcept, R, list<UsedSourceArgs...>, list<UnusedSourceArgs...>,
               list<UsedTargetArgs...>, list<UnusedTargetArgs...>> {
-  inline static constexpr decltype(auto) f(UsedTargetArgs... args, UnusedTargetArgs...) noexcept(
+  STATIC_FUNCTIONAL_FUSE inline static constexpr decltype(auto)
+  f(UsedTargetArgs... args, UnusedTargetArgs... unused) noexcept(
       CastToNoExcept ||
       noexcept(R(F(UsedSourceArgs(maybe_move<UsedTargetArgs>(args))..., UnusedSourceArgs()...)))) {
-    return R(F(UsedSourceArgs(maybe_move<UsedTargetArgs>(args))..., UnusedSourceArgs()...));
+    return call(args..., unused...);
+  }
+  STATIC_FUNCTIONAL_FUSE inline static constexpr decltype(auto)
+  call(std::remove_reference_t<UsedTargetArgs>&... args,
+       std::remove_reference_t<UnusedTargetArgs>&...) {
+    if constexpr (is_fused<F> && (fusable_arg<UsedSourceArgs, UsedTargetArgs> && ...)) {
+      return R(fused_t<F>::call(as_lvalue(fused_arg<UsedSourceArgs, UsedTargetArgs>(args))...,
+                                as_lvalue(UnusedSourceArgs())...));
+    } else {
+      return R(F(UsedSourceArgs(maybe_move<UsedTargetArgs>(args))..., UnusedSourceArgs()...));
+    }
   }
 };
 
@@ -223,8 +356,8 @@ struct cast_impl {
 
   template <function auto F>
   inline static constexpr auto cast =
-      &cast_f<F, is_noexcept<Target>, return_type_of<Target>, used_source_args, unused_source_args,
-              used_target_args, unused_target_args>::f;
+      fused_f<cast_f<F, is_noexcept<Target>, return_type_of<Target>, used_source_args,
+                     unused_source_args, used_target_args, unused_target_args>>;
 };
 
 template <function_type T, function auto F,
@@ -272,7 +405,8 @@ constexpr bool all_reinterpretable(list<Froms...>, list<Tos...>) {
 }
 template <typename From, typename To>
 requires is_reinterpretable<From, To>
-decltype(auto) maybe_reinterpret(typename std::remove_reference_t<From>& v) noexcept {
+STATIC_FUNCTIONAL_FUSE inline decltype(auto)
+maybe_reinterpret(typename std::remove_reference_t<From>& v) noexcept {
   if constexpr (std::is_same_v<From, To>) {
     return maybe_move<To>(v);
   } else if constexpr (std::is_reference_v<From> && std::is_pointer_v<To>) {
@@ -289,7 +423,7 @@ struct reinterpret_f;
 template <function auto F, typename SourceR, typename TargetR, typename... SourceArgs,
           typename... TargetArgs>
 struct reinterpret_f<F, SourceR, TargetR, list<SourceArgs...>, list<TargetArgs...>> {
-  inline static decltype(auto)
+  STATIC_FUNCTIONAL_FUSE inline static decltype(auto)
   f(TargetArgs... args) noexcept(noexcept(F(maybe_reinterpret<TargetArgs, SourceArgs>(args)...))) {
     if constexpr (std::is_same_v<SourceR, TargetR>) {
       return F(maybe_reinterpret<TargetArgs, SourceArgs>(args)...);
@@ -327,6 +461,52 @@ template <function_type T, function auto F>
 requires reinterpretable_as<decltype(F), T>
 inline constexpr auto reinterpret = detail::reinterpret_if<T, unwrap<F>>::value;
 
+//-------------------------------------------------------------------------------------------------
+// c_callback / c_callback_front / c_callback_back
+//-------------------------------------------------------------------------------------------------
+namespace detail {
+template <bool Front, member_function auto F, typename C, type_list>
+struct c_callback_f;
+template <member_function auto F, typename C, typename... Args>
+struct c_callback_f<true, F, C, list<Args...>> {
+  STATIC_FUNCTIONAL_FUSE inline static constexpr decltype(auto)
+  f(void* userdata, Args... args) noexcept(noexcept((std::declval<C>().*F)(
+      maybe_move<Args>(std::declval<std::remove_reference_t<Args>&>())...))) {
+    return (static_cast<C>(*static_cast<std::remove_reference_t<C>*>(userdata)).*F)(
+        maybe_move<Args>(args)...);
+  }
+};
+template <member_function auto F, typename C, typename... Args>
+struct c_callback_f<false, F, C, list<Args...>> {
+  STATIC_FUNCTIONAL_FUSE inline static constexpr decltype(auto)
+  f(Args... args, void* userdata) noexcept(noexcept((std::declval<C>().*F)(
+      maybe_move<Args>(std::declval<std::remove_reference_t<Args>&>())...))) {
+    return (static_cast<C>(*static_cast<std::remove_reference_t<C>*>(userdata)).*F)(
+        maybe_move<Args>(args)...);
+  }
+};
+
+template <bool Front, member_function T>
+struct c_callback_impl {
+  using object = front<parameter_types_of<T>>;
+  using args = drop_front<parameter_types_of<T>>;
+
+  template <member_function auto F>
+  inline static constexpr auto c_callback = &c_callback_f<Front, F, object, args>::f;
+};
+}  // namespace detail
+
+template <member_function auto F>
+inline constexpr auto c_callback_front =
+    detail::c_callback_impl<true, decltype(F)>::template c_callback<F>;
+
+template <member_function auto F>
+inline constexpr auto c_callback_back =
+    detail::c_callback_impl<false, decltype(F)>::template c_callback<F>;
+
+template <member_function auto F>
+inline constexpr auto c_callback = c_callback_front<F>;
+
 //-------------------------------------------------------------------------------------------------
 // bind_front / bind_back
 //-------------------------------------------------------------------------------------------------
@@ -335,18 +515,34 @@ template <bool Front, function auto F, type_list, type_list, auto...>
 struct bind_f;
 template <function auto F, typename... BoundArgs, typename... UnboundArgs, auto... Values>
 struct bind_f<true, F, list<BoundArgs...>, list<UnboundArgs...>, Values...> {
-  inline static constexpr decltype(auto)
+  STATIC_FUNCTIONAL_FUSE inline static constexpr decltype(auto)
   f(UnboundArgs... args) noexcept(noexcept(F(BoundArgs(Values)...,
                                              maybe_move<UnboundArgs>(args)...))) {
-    return F(BoundArgs(Values)..., maybe_move<UnboundArgs>(args)...);
+    return call(args...);
+  }
+  STATIC_FUNCTIONAL_FUSE inline static constexpr decltype(auto)
+  call(std::remove_reference_t<UnboundArgs>&... args) {
+    if constexpr (is_fused<F>) {
+      return fused_t<F>::call(as_lvalue(BoundArgs(Values))..., args...);
+    } else {
+      return F(BoundArgs(Values)..., maybe_move<UnboundArgs>(args)...);
+    }
   }
 };
 template <function auto F, typename... BoundArgs, typename... UnboundArgs, auto... Values>
 struct bind_f<false, F, list<BoundArgs...>, list<UnboundArgs...>, Values...> {
-  inline static constexpr decltype(auto)
+  STATIC_FUNCTIONAL_FUSE inline static constexpr decltype(auto)
   f(UnboundArgs... args) noexcept(noexcept(F(maybe_move<UnboundArgs>(args)...,
                                              BoundArgs(Values)...))) {
-    return F(maybe_move<UnboundArgs>(args)..., BoundArgs(Values)...);
+    return call(args...);
+  }
+  STATIC_FUNCTIONAL_FUSE inline static constexpr decltype(auto)
+  call(std::remove_reference_t<UnboundArgs>&... args) {
+    if constexpr (is_fused<F>) {
+      return fused_t<F>::call(args..., as_lvalue(BoundArgs(Values))...);
+    } else {
+      return F(maybe_move<UnboundArgs>(args)..., BoundArgs(Values)...);
+    }
   }
 };
 
@@ -362,7 +558,8 @@ struct bind_impl {
       all_constructible(bound_args{}, list<const Args&...>{});
 
   template <function auto F, auto... Values>
-  inline static constexpr auto bind = &bind_f<Front, F, bound_args, unbound_args, Values...>::f;
+  inline static constexpr auto bind =
+      fused_f<bind_f<Front, F, bound_args, unbound_args, Values...>>;
 };
 
 template <bool Front, function auto F, auto... Values>
@@ -401,10 +598,18 @@ struct compose_front_f;
 template <typename... GArgs, typename... FArgs, typename ComposedArg, function auto G,
           function auto F>
 struct compose_front_f<list<GArgs...>, list<FArgs...>, ComposedArg, G, F> {
-  inline static constexpr decltype(auto)
+  STATIC_FUNCTIONAL_FUSE inline static constexpr decltype(auto)
   f(FArgs... fargs, GArgs... gargs) noexcept(noexcept(G(ComposedArg(F(maybe_move<FArgs>(fargs)...)),
                                                         maybe_move<GArgs>(gargs)...))) {
-    return G(ComposedArg(F(maybe_move<FArgs>(fargs)...)), maybe_move<GArgs>(gargs)...);
+    return call(fargs..., gargs...);
+  }
+  STATIC_FUNCTIONAL_FUSE inline static constexpr decltype(auto)
+  call(std::remove_reference_t<FArgs>&... fargs, std::remove_reference_t<GArgs>&... gargs) {
+    if constexpr (is_fused<G>) {
+      return fused_t<G>::call(as_lvalue(ComposedArg(fused_call<F, FArgs...>(fargs...))), gargs...);
+    } else {
+      return G(ComposedArg(fused_call<F, FArgs...>(fargs...)), maybe_move<GArgs>(gargs)...);
+    }
   }
 };
 
@@ -413,9 +618,18 @@ struct compose_back_f;
 template <typename... GArgs, typename... FArgs, typename ComposedArg, function auto G,
           function auto F>
 struct compose_back_f<list<GArgs...>, list<FArgs...>, ComposedArg, G, F> {
-  inline static constexpr decltype(auto) f(GArgs... gargs, FArgs... fargs) noexcept(
+  STATIC_FUNCTIONAL_FUSE inline static constexpr decltype(auto)
+  f(GArgs... gargs, FArgs... fargs) noexcept(
       noexcept(G(maybe_move<GArgs>(gargs)..., ComposedArg(F(maybe_move<FArgs>(fargs)...))))) {
-    return G(maybe_move<GArgs>(gargs)..., ComposedArg(F(maybe_move<FArgs>(fargs)...)));
+    return call(gargs..., fargs...);
+  }
+  STATIC_FUNCTIONAL_FUSE inline static constexpr decltype(auto)
+  call(std::remove_reference_t<GArgs>&... gargs, std::remove_reference_t<FArgs>&... fargs) {
+    if constexpr (is_fused<G>) {
+      return fused_t<G>::call(gargs..., as_lvalue(ComposedArg(fused_call<F, FArgs...>(fargs...))));
+    } else {
+      return G(maybe_move<GArgs>(gargs)..., ComposedArg(fused_call<F, FArgs...>(fargs...)));
+    }
   }
 };
 
@@ -429,7 +643,7 @@ struct compose_front_impl {
       std::is_constructible_v<composed_arg, return_type_of<FType>>;
 
   template <function auto G, function auto F>
-  inline static constexpr auto compose = &compose_front_f<gargs, fargs, composed_arg, G, F>::f;
+  inline static constexpr auto compose = fused_f<compose_front_f<gargs, fargs, composed_arg, G, F>>;
 };
 
 template <functional GType, functional FType>
@@ -442,7 +656,7 @@ struct compose_back_impl {
       std::is_constructible_v<composed_arg, return_type_of<FType>>;
 
   template <function auto G, function auto F>
-  inline static constexpr auto compose = &compose_back_f<gargs, fargs, composed_arg, G, F>::f;
+  inline static constexpr auto compose = fused_f<compose_back_f<gargs, fargs, composed_arg, G, F>>;
 };
 }  // namespace detail
 
@@ -471,6 +685,645 @@ template <function auto G, function auto F>
 requires composable<decltype(G), decltype(F)>
 inline constexpr auto compose = compose_front<G, F>;
 
+//-------------------------------------------------------------------------------------------------
+// pipeline / pipeline_front / pipeline_back
+//-------------------------------------------------------------------------------------------------
+namespace detail {
+// Every stage after the first takes the result of the previous stage as its first (Front) or last
+// parameter; its other parameters are extra arguments of the pipeline.
+template <bool Front, type_list Parameters>
+struct pipeline_stage {
+  using composed_arg = void;
+  using extra_args = list<>;
+};
+template <bool Front, type_list Parameters>
+requires(!empty<Parameters>) struct pipeline_stage<Front, Parameters> {
+  using composed_arg = std::conditional_t<Front, front<Parameters>, back<Parameters>>;
+  using extra_args = std::conditional_t<Front, drop_front<Parameters>, drop_back<Parameters>>;
+};
+
+struct pipeline_end {};
+template <typename T, typename R>
+inline constexpr bool pipeline_convertible = std::is_constructible_v<T, R>;
+template <typename R>
+inline constexpr bool pipeline_convertible<pipeline_end, R> = true;
+
+// Joins the parameter lists of all stages with a single fold expression. Extra arguments come in
+// stage order for Front pipelines and in reverse order otherwise, as with nested compose_front and
+// compose_back.
+template <bool Front, type_list Parameters>
+struct pipeline_parameters {
+  using type = Parameters;
+};
+template <typename... As, typename... Bs>
+auto operator+(pipeline_parameters<true, list<As...>>, pipeline_parameters<true, list<Bs...>>)
+    -> pipeline_parameters<true, list<As..., Bs...>>;
+template <typename... As, typename... Bs>
+auto operator+(pipeline_parameters<false, list<As...>>, pipeline_parameters<false, list<Bs...>>)
+    -> pipeline_parameters<false, list<Bs..., As...>>;
+
+// Indexed lookup into a pack of values, with constant instantiation depth.
+template <std::size_t N, auto V>
+struct indexed_value {};
+template <typename, auto...>
+struct indexed_values;
+template <std::size_t... Ns, auto... Vs>
+struct indexed_values<std::index_sequence<Ns...>, Vs...> : indexed_value<Ns, Vs>... {};
+template <std::size_t N, auto V>
+constexpr auto get_indexed_value(const indexed_value<N, V>*) {
+  return V;
+}
+
+template <std::size_t I, typename Functions>
+inline constexpr auto pipeline_function =
+    get_indexed_value<I>(static_cast<const Functions*>(nullptr));
+
+// Number of arguments of the pipeline which are passed to stage I.
+template <std::size_t I, typename Functions>
+inline constexpr std::size_t pipeline_arg_count =
+    size<parameter_types_of<decltype(pipeline_function<I, Functions>)>> - (I != 0u);
+
+// Calls stage I with references to the arguments of stages 0 to I, split into those for the
+// earlier stages and those for stage I (in the reverse order if !Front). Each stage is a separate
+// struct, recursing on stage I - 1, but they are all fused into the pipeline function. Every stage
+// shares the one indexed_values type of all stages and looks its function up in it without
+// recursion, and splits its arguments with a single sublist, so a pipeline of N stages takes N
+// stage instantiations rather than N nested compositions, each with its own argument lists.
+template <bool Front, std::size_t I, typename Functions, type_list, type_list>
+struct pipeline_call;
+template <bool Front, std::size_t I, typename Functions, type_list Args,
+          std::size_t Split = Front ? size<Args> - pipeline_arg_count<I, Functions>
+                                    : pipeline_arg_count<I, Functions>>
+using pipeline_call_t =
+    pipeline_call<Front, I, Functions, sublist<Args, 0, Split>, sublist<Args, Split>>;
+
+template <bool Front, std::size_t I, typename Functions, typename... Lead, typename... Trail>
+struct pipeline_call<Front, I, Functions, list<Lead...>, list<Trail...>> {
+  inline static constexpr auto stage_f = pipeline_function<I, Functions>;
+  using composed_arg =
+      typename pipeline_stage<Front, parameter_types_of<decltype(stage_f)>>::composed_arg;
+
+  STATIC_FUNCTIONAL_FUSE inline static constexpr decltype(auto)
+  f(std::remove_reference_t<Lead>&... lead, std::remove_reference_t<Trail>&... trail) noexcept(
+      noexcept(stage_f(maybe_move<Lead>(lead)..., maybe_move<Trail>(trail)...)))
+  requires(I == 0u) {
+    return fused_call<stage_f, Lead..., Trail...>(lead..., trail...);
+  }
+  STATIC_FUNCTIONAL_FUSE inline static constexpr decltype(auto)
+  f(std::remove_reference_t<Lead>&... lead, std::remove_reference_t<Trail>&... trail) noexcept(
+      noexcept(stage_f(
+          composed_arg(pipeline_call_t<Front, I - 1u, Functions, list<Lead...>>::f(lead...)),
+          maybe_move<Trail>(trail)...)))
+  requires(I != 0u && Front) {
+    using previous = pipeline_call_t<Front, I - 1u, Functions, list<Lead...>>;
+    if constexpr (is_fused<stage_f>) {
+      return fused_t<stage_f>::call(as_lvalue(composed_arg(previous::f(lead...))), trail...);
+    } else {
+      return stage_f(composed_arg(previous::f(lead...)), maybe_move<Trail>(trail)...);
+    }
+  }
+  STATIC_FUNCTIONAL_FUSE inline static constexpr decltype(auto)
+  f(std::remove_reference_t<Lead>&... lead, std::remove_reference_t<Trail>&... trail) noexcept(
+      noexcept(stage_f(
+          maybe_move<Lead>(lead)...,
+          composed_arg(pipeline_call_t<Front, I - 1u, Functions, list<Trail...>>::f(trail...)))))
+  requires(I != 0u && !Front) {
+    using previous = pipeline_call_t<Front, I - 1u, Functions, list<Trail...>>;
+    if constexpr (is_fused<stage_f>) {
+      return fused_t<stage_f>::call(lead..., as_lvalue(composed_arg(previous::f(trail...))));
+    } else {
+      return stage_f(maybe_move<Lead>(lead)..., composed_arg(previous::f(trail...)));
+    }
+  }
+};
+
+template <bool Front, type_list, function auto... F>
+struct pipeline_f;
+template <bool Front, typename... Args, function auto... F>
+struct pipeline_f<Front, list<Args...>, F...> {
+  using functions = indexed_values<std::index_sequence_for<decltype(F)...>, F...>;
+  using last = pipeline_call_t<Front, sizeof...(F) - 1u, functions, list<Args...>>;
+
+  STATIC_FUNCTIONAL_FUSE inline static constexpr decltype(auto) f(Args... args) noexcept(
+      noexcept(last::f(std::declval<std::remove_reference_t<Args>&>()...))) {
+    return call(args...);
+  }
+  STATIC_FUNCTIONAL_FUSE inline static constexpr decltype(auto)
+  call(std::remove_reference_t<Args>&... args) {
+    return last::f(args...);
+  }
+};
+
+template <bool Front, functional First, functional... Rest>
+struct pipeline_impl {
+  template <functional T>
+  using extra_parameters =
+      pipeline_parameters<Front, typename pipeline_stage<Front, parameter_types_of<T>>::extra_args>;
+  using parameters = typename decltype((pipeline_parameters<Front, parameter_types_of<First>>{} +
+                                        ... + extra_parameters<Rest>{}))::type;
+
+  // Each stage is paired with the next one's composed argument type, and the last with a sentinel.
+  template <typename... Previous, typename... Next>
+  static constexpr bool all_convertible(list<Previous...>, list<Next...>) {
+    return (pipeline_convertible<Next, return_type_of<Previous>> && ...);
+  }
+  inline static constexpr bool type_convertible = all_convertible(
+      list<First, Rest...>{},
+      list<typename pipeline_stage<Front, parameter_types_of<Rest>>::composed_arg...,
+           pipeline_end>{});
+  inline static constexpr bool single_parameter = ((size<parameter_types_of<Rest>> == 1u) && ...);
+
+  template <function auto... F>
+  inline static constexpr auto pipeline = fused_f<pipeline_f<Front, parameters, F...>>;
+};
+}  // namespace detail
+
+template <typename... F>
+concept pipeable_front = sizeof...(F) != 0u && (functional<F> && ...) &&
+    detail::pipeline_impl<true, F...>::type_convertible;
+
+template <typename... F>
+concept pipeable_back = sizeof...(F) != 0u && (functional<F> && ...) &&
+    detail::pipeline_impl<false, F...>::type_convertible;
+
+template <typename... F>
+concept pipeable = pipeable_front<F...> && detail::pipeline_impl<true, F...>::single_parameter;
+
+template <function auto... F>
+requires pipeable_front<decltype(F)...>
+inline constexpr auto pipeline_front =
+    detail::pipeline_impl<true, decltype(F)...>::template pipeline<unwrap<F>...>;
+
+template <function auto... F>
+requires pipeable_back<decltype(F)...>
+inline constexpr auto pipeline_back =
+    detail::pipeline_impl<false, decltype(F)...>::template pipeline<unwrap<F>...>;
+
+template <function auto... F>
+requires pipeable<decltype(F)...>
+inline constexpr auto pipeline = pipeline_front<F...>;
+
+//-------------------------------------------------------------------------------------------------
+// dispatch_table / dispatch_table_or
+//-------------------------------------------------------------------------------------------------
+namespace detail {
+template <function_type T, function auto... F>
+inline constexpr ptr<T> dispatch_table_entries[] = {cast<T, F>...};
+
+// Same as (Values && ...), but fast to compile for thousands of values.
+template <bool... Values>
+inline constexpr bool all_values = [] {
+  constexpr bool values[] = {Values..., true};
+  for (bool value : values) {
+    if (!value) {
+      return false;
+    }
+  }
+  return true;
+}();
+
+template <function_type T, type_list, function auto... F>
+struct dispatch_table_f;
+template <function_type T, typename... Args, function auto... F>
+struct dispatch_table_f<T, list<Args...>, F...> {
+  STATIC_FUNCTIONAL_FUSE inline static constexpr decltype(auto)
+  f(std::size_t index, Args... args) noexcept(
+      all_values<noexcept(cast<T, F>(maybe_move<Args>(args)...))...>) {
+    return dispatch_table_entries<T, F...>[index](maybe_move<Args>(args)...);
+  }
+};
+
+template <function_type T, type_list, function auto Default, function auto... F>
+struct dispatch_table_or_f;
+template <function_type T, typename... Args, function auto Default, function auto... F>
+struct dispatch_table_or_f<T, list<Args...>, Default, F...> {
+  STATIC_FUNCTIONAL_FUSE inline static constexpr decltype(auto)
+  f(std::size_t index, Args... args) noexcept(
+      noexcept(cast<T, Default>(maybe_move<Args>(args)...)) &&
+      all_values<noexcept(cast<T, F>(maybe_move<Args>(args)...))...>) {
+    return dispatch_table_entries<T, F..., Default>[index < sizeof...(F) ? index : sizeof...(F)](
+        maybe_move<Args>(args)...);
+  }
+};
+}  // namespace detail
+
+template <typename T, typename... Rest>
+concept dispatchable = functional<T> &&(castable_to<Rest, function_type_of<T>>&&...);
+
+template <function auto F, function auto... Rest>
+requires dispatchable<decltype(F), decltype(Rest)...>
+inline constexpr auto dispatch_table =
+    &detail::dispatch_table_f<function_type_of<decltype(F)>, parameter_types_of<decltype(F)>, F,
+                              Rest...>::f;
+
+template <function auto Default, function auto... F>
+requires dispatchable<decltype(Default), decltype(F)...>
+inline constexpr auto dispatch_table_or =
+    &detail::dispatch_table_or_f<function_type_of<decltype(Default)>,
+                                 parameter_types_of<decltype(Default)>, Default, F...>::f;
+
+//-------------------------------------------------------------------------------------------------
+// type_switch / type_switch_or
+//-------------------------------------------------------------------------------------------------
+template <typename T, template <typename> typename Handler>
+concept type_switch_handler = requires {
+  { &Handler<T>::f } -> function;
+};
+
+namespace detail {
+template <typename F, typename... Rest>
+constexpr bool type_switch_dispatchable() {
+  return dispatchable<F, Rest...>;
+}
+template <template <typename> typename Handler>
+struct type_switch_handler_metafunction {
+  template <typename T>
+  struct predicate : std::bool_constant<type_switch_handler<T, Handler>> {};
+};
+// Uses find_if_not rather than a fold expression, which is slow to compile for long lists.
+template <template <typename> typename Handler, typename Default, typename... Ts>
+constexpr bool type_switch_valid(list<Ts...>) {
+  using has_handler = type_switch_handler_metafunction<Handler>;
+  if constexpr (find_if_not<list<Ts...>, has_handler::template predicate> != sizeof...(Ts)) {
+    return false;
+  } else if constexpr (std::is_void_v<Default>) {
+    return type_switch_dispatchable<decltype(&Handler<Ts>::f)...>();
+  } else {
+    return type_switch_dispatchable<Default, decltype(&Handler<Ts>::f)...>();
+  }
+}
+
+// One instantiation of Handler per element, in a single pack expansion: the dispatch table is
+// built without recursion, so compile time is linear in the length of the list.
+template <type_list List, template <typename> typename Handler, auto... Default>
+struct type_switch_impl;
+template <typename... Ts, template <typename> typename Handler>
+struct type_switch_impl<list<Ts...>, Handler> {
+  inline static constexpr auto value = dispatch_table<&Handler<Ts>::f...>;
+};
+template <typename... Ts, template <typename> typename Handler, function auto Default>
+struct type_switch_impl<list<Ts...>, Handler, Default> {
+  inline static constexpr auto value = dispatch_table_or<Default, &Handler<Ts>::f...>;
+};
+}  // namespace detail
+
+template <typename List, template <typename> typename Handler>
+concept type_switchable =
+    type_list<List> && !empty<List> && detail::type_switch_valid<Handler, void>(List{});
+
+template <typename List, template <typename> typename Handler, typename Default>
+concept type_switchable_or = type_list<List> && functional<Default> &&
+    detail::type_switch_valid<Handler, Default>(List{});
+
+template <typename List, template <typename> typename Handler>
+requires type_switchable<List, Handler>
+inline constexpr auto type_switch = detail::type_switch_impl<List, Handler>::value;
+
+template <typename List, template <typename> typename Handler, function auto Default>
+requires type_switchable_or<List, Handler, decltype(Default)>
+inline constexpr auto type_switch_or = detail::type_switch_impl<List, Handler, Default>::value;
+
+//-------------------------------------------------------------------------------------------------
+// specialize
+//-------------------------------------------------------------------------------------------------
+namespace detail {
+template <typename T>
+struct specialize_key {
+  using type = T;
+};
+template <typename T>
+requires std::is_enum_v<T>
+struct specialize_key<T> {
+  using type = std::underlying_type_t<T>;
+};
+
+// A clone of F with the parameter P fixed to the constant V. It keeps the signature of F, ignoring
+// the argument it replaces, so that all of the clones fit in one table alongside F itself. This is
+// bind_f's call with the bound parameter left in place: bind_f drops the parameters it binds, and
+// can only bind leading or trailing ones, whereas P may be anywhere.
+template <function auto F, type_list, type_list, auto V>
+struct specialize_f;
+template <function auto F, typename... Before, typename P, typename... After, auto V>
+struct specialize_f<F, list<Before...>, list<P, After...>, V> {
+  STATIC_FUNCTIONAL_FUSE inline static constexpr decltype(auto)
+  f(Before... before, P, After... after) noexcept(
+      noexcept(F(maybe_move<Before>(before)..., P(V), maybe_move<After>(after)...))) {
+    return F(maybe_move<Before>(before)..., P(V), maybe_move<After>(after)...);
+  }
+};
+
+// Values spanning at most this many keys are looked up in a table indexed by key - min; otherwise,
+// by a chain of comparisons (which compilers turn into a switch).
+inline constexpr std::uintmax_t specialize_max_table_size = 256;
+
+template <function_type T, function auto F, type_list, type_list, auto... V>
+struct specialize_table_f;
+template <function_type T, function auto F, typename... Before, typename P, typename... After,
+          auto... V>
+struct specialize_table_f<T, F, list<Before...>, list<P, After...>, V...> {
+  using value_type = std::remove_cvref_t<P>;
+  using key = typename specialize_key<value_type>::type;
+  template <value_type W>
+  inline static constexpr ptr<T> clone = &specialize_f<F, list<Before...>, list<P, After...>, W>::f;
+
+  struct range {
+    std::uintmax_t min = 0;
+    std::uintmax_t size = 0;
+  };
+  inline static constexpr range keys = [] {
+    key values[] = {key(value_type(V))...};
+    key min = values[0];
+    key max = values[0];
+    for (key k : values) {
+      min = k < min ? k : min;
+      max = k > max ? k : max;
+    }
+    auto span = static_cast<std::uintmax_t>(max) - static_cast<std::uintmax_t>(min);
+    return range{static_cast<std::uintmax_t>(min),
+                 span < specialize_max_table_size ? span + 1u : 0u};
+  }();
+
+  // Clones for each key in range, followed by the generic function for all other keys.
+  struct table_t {
+    ptr<T> entries[keys.size + 1u];
+  };
+  inline static constexpr table_t table = [] {
+    table_t t{};
+    for (auto& entry : t.entries) {
+      entry = F;
+    }
+    ((t.entries[static_cast<std::uintmax_t>(key(value_type(V))) - keys.min] =
+          clone<value_type(V)>),
+     ...);
+    return t;
+  }();
+
+  STATIC_FUNCTIONAL_FUSE inline static constexpr decltype(auto)
+  f(Before... before, P p, After... after) noexcept(noexcept(
+      F(maybe_move<Before>(before)..., maybe_move<P>(p), maybe_move<After>(after)...))) {
+    if constexpr (keys.size != 0u) {
+      auto i = static_cast<std::uintmax_t>(key(p)) - keys.min;
+      return table.entries[i < keys.size ? i : keys.size](
+          maybe_move<Before>(before)..., maybe_move<P>(p), maybe_move<After>(after)...);
+    } else {
+      ptr<T> g = F;
+      (void)((key(p) == key(value_type(V)) && (g = clone<value_type(V)>, true)) || ...);
+      return g(maybe_move<Before>(before)..., maybe_move<P>(p), maybe_move<After>(after)...);
+    }
+  }
+};
+
+template <function auto F, std::size_t I, auto... V>
+struct specialize_if {
+  using parameter_types = parameter_types_of<decltype(F)>;
+  static inline constexpr auto value =
+      &specialize_table_f<function_type_of<decltype(F)>, F, sublist<parameter_types, 0u, I>,
+                          sublist<parameter_types, I>, V...>::f;
+};
+template <function auto F, std::size_t I>
+struct specialize_if<F, I> {
+  static inline constexpr auto value = F;
+};
+
+template <typename F, std::size_t I>
+using specialize_parameter = get<parameter_types_of<F>, I>;
+template <typename F, std::size_t I>
+using specialize_value = std::remove_cvref_t<specialize_parameter<F, I>>;
+}  // namespace detail
+
+template <typename F, std::size_t I, typename... Values>
+concept specializable = functional<F> &&(I < size<parameter_types_of<F>>)&&(
+    std::is_integral_v<detail::specialize_value<F, I>> ||
+    std::is_enum_v<detail::specialize_value<F, I>>) &&
+    std::is_constructible_v<detail::specialize_parameter<F, I>, detail::specialize_value<F, I>> &&
+    (std::is_convertible_v<Values, detail::specialize_value<F, I>> && ...);
+
+template <function auto F, std::size_t I, auto... V>
+requires specializable<decltype(F), I, decltype(V)...>
+inline constexpr auto specialize = detail::specialize_if<unwrap<F>, I, V...>::value;
+
+//-------------------------------------------------------------------------------------------------
+// tabulate / tabulate_or
+//-------------------------------------------------------------------------------------------------
+namespace detail {
+// The values Lo, Lo + 1, ..., Hi of an integral or enum parameter type T.
+template <typename T, auto Lo, auto Hi>
+struct tabulate_domain {
+  using value_type = std::remove_cvref_t<T>;
+  using key = typename specialize_key<value_type>::type;
+  inline static constexpr bool ordered = !(key(value_type(Hi)) < key(value_type(Lo)));
+  inline static constexpr std::uintmax_t min = static_cast<std::uintmax_t>(key(value_type(Lo)));
+  inline static constexpr std::uintmax_t size =
+      static_cast<std::uintmax_t>(key(value_type(Hi))) - min + 1u;
+
+  STATIC_FUNCTIONAL_FUSE inline static constexpr std::uintmax_t
+  index(const value_type& v) noexcept {
+    return static_cast<std::uintmax_t>(key(v)) - min;
+  }
+  inline static constexpr value_type value(std::uintmax_t i) noexcept {
+    return value_type(key(min + i));
+  }
+};
+
+// Pairs up each parameter of F with its (Lo, Hi) bounds.
+template <type_list Parameters, typename Bounds,
+          typename = std::make_index_sequence<size<Parameters>>>
+struct tabulate_domains;
+template <typename... Parameters, typename Bounds, std::size_t... Ns>
+struct tabulate_domains<list<Parameters...>, Bounds, std::index_sequence<Ns...>> {
+  using type = list<tabulate_domain<
+      Parameters, get_indexed_value<2u * Ns>(static_cast<const Bounds*>(nullptr)),
+      get_indexed_value<2u * Ns + 1u>(static_cast<const Bounds*>(nullptr))>...>;
+};
+
+template <type_list Parameters, auto... Bounds>
+using tabulate_domains_t = typename tabulate_domains<
+    Parameters, indexed_values<std::make_index_sequence<sizeof...(Bounds)>, Bounds...>>::type;
+
+template <type_list Parameters, type_list Bounds,
+          typename = std::make_index_sequence<size<Parameters>>>
+inline constexpr bool tabulate_bounds_convertible = false;
+template <typename... Parameters, type_list Bounds, std::size_t... Ns>
+inline constexpr bool
+    tabulate_bounds_convertible<list<Parameters...>, Bounds, std::index_sequence<Ns...>> =
+        ((std::is_integral_v<std::remove_cvref_t<Parameters>> ||
+          std::is_enum_v<std::remove_cvref_t<Parameters>>)&&...) &&
+        ((std::is_convertible_v<get<Bounds, 2u * Ns>, std::remove_cvref_t<Parameters>> &&
+          std::is_convertible_v<get<Bounds, 2u * Ns + 1u>, std::remove_cvref_t<Parameters>>)&&...);
+
+// Results of F for every combination of arguments, with the last parameter varying fastest.
+template <function auto F, type_list Domains>
+struct tabulate_table;
+template <function auto F, typename... Domains>
+struct tabulate_table<F, list<Domains...>> {
+  using value_type = std::remove_cvref_t<return_type_of<decltype(F)>>;
+  inline static constexpr std::uintmax_t size = (Domains::size * ... * 1u);
+  inline static constexpr bool ordered = (Domains::ordered && ...);
+
+  STATIC_FUNCTIONAL_FUSE inline static constexpr std::uintmax_t
+  index(const typename Domains::value_type&... v) noexcept {
+    std::uintmax_t i = 0;
+    ((i = i * Domains::size + Domains::index(v)), ...);
+    return i;
+  }
+  STATIC_FUNCTIONAL_FUSE inline static constexpr bool
+  contains(const typename Domains::value_type&... v) noexcept {
+    return ((Domains::index(v) < Domains::size) && ...);
+  }
+
+  struct table_t {
+    value_type entries[size];
+  };
+  inline static constexpr table_t table = [] {
+    constexpr std::uintmax_t sizes[] = {Domains::size...};
+    table_t t{};
+    for (std::uintmax_t i = 0; i < size; ++i) {
+      std::uintmax_t digits[sizeof...(Domains)];
+      for (std::size_t k = sizeof...(Domains), rest = i; k-- > 0u; rest /= sizes[k]) {
+        digits[k] = rest % sizes[k];
+      }
+      t.entries[i] = [&]<std::size_t... Ks>(std::index_sequence<Ks...>) {
+        return F(Domains::value(digits[Ks])...);
+      }(std::index_sequence_for<Domains...>{});
+    }
+    return t;
+  }();
+};
+
+template <typename Table, bool Checked, function auto F, typename R, type_list>
+struct tabulate_f;
+template <typename Table, function auto F, typename R, typename... Args>
+struct tabulate_f<Table, false, F, R, list<Args...>> {
+  STATIC_FUNCTIONAL_FUSE inline static constexpr R f(Args... args) noexcept(
+      std::is_nothrow_constructible_v<R, const typename Table::value_type&>) {
+    return Table::table.entries[Table::index(args...)];
+  }
+};
+template <typename Table, function auto F, typename R, typename... Args>
+struct tabulate_f<Table, true, F, R, list<Args...>> {
+  STATIC_FUNCTIONAL_FUSE inline static constexpr R f(Args... args) noexcept(
+      std::is_nothrow_constructible_v<R, const typename Table::value_type&> &&
+      noexcept(F(maybe_move<Args>(args)...))) {
+    if (Table::contains(args...)) {
+      return Table::table.entries[Table::index(args...)];
+    }
+    return F(maybe_move<Args>(args)...);
+  }
+};
+
+template <bool Checked, function auto F, auto... Bounds>
+struct tabulate_impl {
+  using table = tabulate_table<F, tabulate_domains_t<parameter_types_of<decltype(F)>, Bounds...>>;
+  inline static constexpr auto value = &tabulate_f<table, Checked, F, return_type_of<decltype(F)>,
+                                                   parameter_types_of<decltype(F)>>::f;
+};
+}  // namespace detail
+
+template <typename F, typename... Bounds>
+concept tabulatable = functional<F> && !std::is_void_v<return_type_of<F>> &&
+    std::is_default_constructible_v<std::remove_cvref_t<return_type_of<F>>> &&
+    std::is_copy_assignable_v<std::remove_cvref_t<return_type_of<F>>> &&
+    (size<parameter_types_of<F>> != 0u) &&
+    (2u * size<parameter_types_of<F>> == sizeof...(Bounds)) &&
+    detail::tabulate_bounds_convertible<parameter_types_of<F>, list<Bounds...>>;
+
+template <function auto F, auto Lo, auto Hi, auto... Bounds>
+requires tabulatable<decltype(F), decltype(Lo), decltype(Hi), decltype(Bounds)...> &&
+    detail::tabulate_impl<false, unwrap<F>, Lo, Hi, Bounds...>::table::ordered
+inline constexpr auto tabulate =
+    detail::tabulate_impl<false, unwrap<F>, Lo, Hi, Bounds...>::value;
+
+template <function auto F, auto Lo, auto Hi, auto... Bounds>
+requires tabulatable<decltype(F), decltype(Lo), decltype(Hi), decltype(Bounds)...> &&
+    detail::tabulate_impl<true, unwrap<F>, Lo, Hi, Bounds...>::table::ordered
+inline constexpr auto tabulate_or =
+    detail::tabulate_impl<true, unwrap<F>, Lo, Hi, Bounds...>::value;
+
+//-------------------------------------------------------------------------------------------------
+// batch
+//-------------------------------------------------------------------------------------------------
+#if defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER)
+#define STATIC_FUNCTIONAL_RESTRICT __restrict
+#else
+#define STATIC_FUNCTIONAL_RESTRICT
+#endif
+
+namespace detail {
+template <typename T>
+inline constexpr bool is_batch_input_mutable = std::is_rvalue_reference_v<T> ||
+    (std::is_lvalue_reference_v<T> && !std::is_const_v<std::remove_reference_t<T>>);
+template <typename T>
+using batch_input = std::conditional_t<is_batch_input_mutable<T>, std::remove_cvref_t<T>,
+                                       const std::remove_cvref_t<T>>;
+template <typename T>
+using batch_output = std::remove_cvref_t<T>;
+
+template <typename T>
+constexpr decltype(auto) batch_element(batch_input<T>* in, std::size_t i) noexcept {
+  if constexpr (std::is_rvalue_reference_v<T>) {
+    return std::move(in[i]);
+  } else {
+    return in[i];
+  }
+}
+template <typename... Args>
+constexpr bool all_batch_constructible(list<Args...>) {
+  return (std::is_constructible_v<Args, decltype(batch_element<Args>(nullptr, 0))> && ...);
+}
+
+template <function auto F, typename R, type_list>
+struct batch_f;
+template <function auto F, typename R, typename... Args>
+struct batch_f<F, R, list<Args...>> {
+  inline static constexpr void
+  f(batch_input<Args>* STATIC_FUNCTIONAL_RESTRICT... in,
+    batch_output<R>* STATIC_FUNCTIONAL_RESTRICT out,
+    std::size_t n) noexcept(noexcept(out[0] = F(batch_element<Args>(in, 0)...))) {
+    for (std::size_t i = 0; i < n; ++i) {
+      out[i] = F(batch_element<Args>(in, i)...);
+    }
+  }
+};
+template <function auto F, typename... Args>
+struct batch_f<F, void, list<Args...>> {
+  inline static constexpr void f(batch_input<Args>* STATIC_FUNCTIONAL_RESTRICT... in,
+                                 std::size_t n) noexcept(noexcept(F(batch_element<Args>(in,
+                                                                                        0)...))) {
+    for (std::size_t i = 0; i < n; ++i) {
+      F(batch_element<Args>(in, i)...);
+    }
+  }
+};
+}  // namespace detail
+
+template <typename T>
+concept batchable = functional<T> && detail::all_batch_constructible(parameter_types_of<T>{}) &&
+    (std::is_void_v<return_type_of<T>> ||
+     std::is_assignable_v<detail::batch_output<return_type_of<T>>&, return_type_of<T>>);
+
+template <function auto F>
+requires batchable<decltype(F)>
+inline constexpr auto batch =
+    &detail::batch_f<unwrap<F>, return_type_of<decltype(F)>, parameter_types_of<decltype(F)>>::f;
+
+//-------------------------------------------------------------------------------------------------
+// string_literal
+//-------------------------------------------------------------------------------------------------
+// A string usable as a template argument, e.g. template <string_literal Name> with Name = "name".
+template <std::size_t N>
+struct string_literal {
+  constexpr string_literal(const char (&s)[N]) noexcept {
+    for (std::size_t i = 0; i < N; ++i) {
+      value[i] = s[i];
+    }
+  }
+  constexpr std::string_view view() const noexcept {
+    return {value, N - 1u};
+  }
+
+  char value[N];
+};
+
 }  // namespace sfn
 
 #endif
@@ -0,0 +1,99 @@
+#ifndef STATIC_FUNCTIONAL_INCLUDE_SFN_HANDLE_H
+#define STATIC_FUNCTIONAL_INCLUDE_SFN_HANDLE_H
+#include <sfn/functional.h>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Maximum number of functions with handles, for each signature. Each signature's table takes
+// 8 bytes per entry of zero-initialized memory, of which only the pages in use are touched.
+#ifndef STATIC_FUNCTIONAL_HANDLE_CAPACITY
+#define STATIC_FUNCTIONAL_HANDLE_CAPACITY 65536
+#endif
+
+namespace sfn {
+//-------------------------------------------------------------------------------------------------
+// handle
+//-------------------------------------------------------------------------------------------------
+inline constexpr std::size_t handle_capacity = STATIC_FUNCTIONAL_HANDLE_CAPACITY;
+
+template <typename T>
+concept handle_index = std::unsigned_integral<T> && !std::same_as<T, bool> && sizeof(T) >= 2u;
+
+namespace detail {
+// One table per signature, shared by handles of every index type. Index 0 is the null handle.
+template <function_type Signature>
+struct handle_table {
+  static std::size_t add(ptr<Signature> f) {
+    auto index = count.fetch_add(1u, std::memory_order_relaxed);
+    if (index >= handle_capacity) {
+      throw std::length_error{"sfn::handle: too many functions with this signature"};
+    }
+    entries[index] = f;
+    return index;
+  }
+
+  inline static constinit ptr<Signature> entries[handle_capacity] = {};
+  inline static constinit std::atomic<std::size_t> count = 1;
+};
+
+// Functions are keyed by their cast to Signature, so that handles of every index type (and
+// equivalent ways of naming the same function) share an entry.
+template <function_type Signature, function auto F>
+inline std::size_t handle_entry() {
+  static const std::size_t index = handle_table<Signature>::add(F);
+  return index;
+}
+}  // namespace detail
+
+// A small integer standing in for a function of type Signature, e.g. to shrink callbacks stored in
+// large queues. handle<Signature, Index>::of<F>() returns the handle for F (which is cast to
+// Signature), registering it on first use; calling a handle is a single table load and indirect
+// call. A default-constructed handle is null, and calling it is undefined behaviour.
+template <function_type Signature, handle_index Index = std::uint32_t>
+class handle {
+public:
+  using index_type = Index;
+
+  constexpr handle() noexcept = default;
+
+  template <function auto F>
+  requires castable_to<decltype(F), Signature>
+  static handle of() {
+    auto index = detail::handle_entry<Signature, cast<Signature, F>>();
+    if (index > std::numeric_limits<Index>::max()) {
+      throw std::length_error{"sfn::handle: index type is too small"};
+    }
+    return handle{static_cast<Index>(index)};
+  }
+
+  template <typename... Args>
+  decltype(auto) operator()(Args&&... args) const
+      noexcept(noexcept(std::declval<ptr<Signature>>()(std::forward<Args>(args)...))) {
+    return detail::handle_table<Signature>::entries[index_](std::forward<Args>(args)...);
+  }
+
+  ptr<Signature> get() const noexcept {
+    return detail::handle_table<Signature>::entries[index_];
+  }
+  constexpr Index index() const noexcept {
+    return index_;
+  }
+  constexpr explicit operator bool() const noexcept {
+    return index_ != 0u;
+  }
+  friend constexpr bool operator==(handle, handle) noexcept = default;
+
+private:
+  constexpr explicit handle(Index index) noexcept : index_{index} {}
+  Index index_ = 0;
+};
+
+}  // namespace sfn
+
+#endif
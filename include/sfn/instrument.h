@@ -0,0 +1,217 @@
+#ifndef STATIC_FUNCTIONAL_INCLUDE_SFN_INSTRUMENT_H
+#define STATIC_FUNCTIONAL_INCLUDE_SFN_INSTRUMENT_H
+#include <sfn/functional.h>
+#include <sfn/type_list.h>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sfn {
+//-------------------------------------------------------------------------------------------------
+// instrument
+//-------------------------------------------------------------------------------------------------
+// Latency histogram buckets are log-linear: each power of two nanoseconds is split into
+// 2^instrument_sub_bucket_bits equal buckets.
+inline constexpr std::size_t instrument_sub_bucket_bits = 2;
+inline constexpr std::size_t instrument_buckets =
+    (64u - instrument_sub_bucket_bits + 1u) << instrument_sub_bucket_bits;
+
+constexpr std::size_t instrument_bucket(std::uint64_t ns) noexcept {
+  constexpr std::uint64_t sub_buckets = 1u << instrument_sub_bucket_bits;
+  if (ns < sub_buckets) {
+    return static_cast<std::size_t>(ns);
+  }
+  auto exponent = static_cast<std::size_t>(std::bit_width(ns)) - 1u;
+  auto shift = exponent - instrument_sub_bucket_bits;
+  return ((shift + 1u) << instrument_sub_bucket_bits) +
+      static_cast<std::size_t>((ns >> shift) & (sub_buckets - 1u));
+}
+
+// Smallest latency in nanoseconds which falls into the given bucket.
+constexpr std::uint64_t instrument_bucket_min(std::size_t bucket) noexcept {
+  constexpr std::uint64_t sub_buckets = 1u << instrument_sub_bucket_bits;
+  if (bucket < sub_buckets) {
+    return bucket;
+  }
+  auto shift = (bucket >> instrument_sub_bucket_bits) - 1u;
+  return (sub_buckets + (bucket & (sub_buckets - 1u))) << shift;
+}
+
+struct instrument_stats {
+  std::uint64_t calls = 0;
+  std::uint64_t total_ns = 0;
+  std::array<std::uint64_t, instrument_buckets> histogram = {};
+
+  // Approximate latency (lower bound of the containing bucket) at the given quantile in [0, 1].
+  constexpr std::uint64_t quantile_ns(double q) const noexcept {
+    if (!calls) {
+      return 0u;
+    }
+    auto rank = static_cast<std::uint64_t>(q * static_cast<double>(calls));
+    rank = rank < calls ? rank : calls - 1u;
+    std::uint64_t count = 0;
+    for (std::size_t i = 0; i < instrument_buckets; ++i) {
+      count += histogram[i];
+      if (count > rank) {
+        return instrument_bucket_min(i);
+      }
+    }
+    return instrument_bucket_min(instrument_buckets - 1u);
+  }
+};
+
+struct instrument_info {
+  std::string_view name;
+  instrument_stats stats;
+};
+
+template <typename T>
+concept instrument_tag = requires {
+  { T::name } -> std::convertible_to<std::string_view>;
+};
+
+namespace detail {
+template <typename Tag>
+constexpr bool instrument_enabled() {
+#ifdef STATIC_FUNCTIONAL_DISABLE_INSTRUMENT
+  return false;
+#else
+  if constexpr (requires { bool{Tag::enabled}; }) {
+    return Tag::enabled;
+  } else {
+    return true;
+  }
+#endif
+}
+
+// Counters for one thread and one instrumented function. Only the owning thread writes to them, so
+// increments are plain relaxed load/store pairs; readers merge them on demand.
+struct alignas(64) instrument_thread_stats {
+  std::atomic<std::uint64_t> calls = 0;
+  std::atomic<std::uint64_t> total_ns = 0;
+  std::atomic<std::uint64_t> histogram[instrument_buckets] = {};
+  instrument_thread_stats* next = nullptr;
+
+  void record(std::uint64_t ns) noexcept {
+    auto increment = [](std::atomic<std::uint64_t>& counter, std::uint64_t value) {
+      counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    };
+    increment(calls, 1u);
+    increment(total_ns, ns);
+    increment(histogram[instrument_bucket(ns)], 1u);
+  }
+};
+
+struct instrument_entry {
+  std::string_view name;
+  instrument_stats (*stats)() noexcept;
+  instrument_entry* next = nullptr;
+};
+
+inline constinit std::atomic<instrument_entry*> instrument_registry = nullptr;
+
+inline bool instrument_register(instrument_entry& entry) noexcept {
+  entry.next = instrument_registry.load(std::memory_order_relaxed);
+  while (!instrument_registry.compare_exchange_weak(entry.next, &entry, std::memory_order_release,
+                                                    std::memory_order_relaxed)) {
+  }
+  return true;
+}
+
+template <function auto F, instrument_tag Tag, type_list>
+struct instrument_f;
+template <function auto F, instrument_tag Tag, typename... Args>
+struct instrument_f<F, Tag, list<Args...>> {
+  struct timer {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    ~timer() {
+      auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start)
+                    .count();
+      if (auto* stats = thread_stats()) {
+        stats->record(static_cast<std::uint64_t>(ns));
+      }
+    }
+  };
+
+  static instrument_thread_stats* thread_stats() noexcept {
+    if (!local && (local = new (std::nothrow) instrument_thread_stats)) {
+      local->next = threads.load(std::memory_order_relaxed);
+      while (!threads.compare_exchange_weak(local->next, local, std::memory_order_release,
+                                            std::memory_order_relaxed)) {
+      }
+    }
+    return local;
+  }
+
+  inline static instrument_stats stats() noexcept {
+    (void)registered;
+    instrument_stats result;
+    for (auto* t = threads.load(std::memory_order_acquire); t; t = t->next) {
+      result.calls += t->calls.load(std::memory_order_relaxed);
+      result.total_ns += t->total_ns.load(std::memory_order_relaxed);
+      for (std::size_t i = 0; i < instrument_buckets; ++i) {
+        result.histogram[i] += t->histogram[i].load(std::memory_order_relaxed);
+      }
+    }
+    return result;
+  }
+
+  inline static decltype(auto) f(Args... args) noexcept(noexcept(F(maybe_move<Args>(args)...))) {
+    (void)registered;
+    timer t;
+    return F(maybe_move<Args>(args)...);
+  }
+
+  // Per-thread counters are allocated on a thread's first call, and kept after it exits so that
+  // its calls are still counted.
+  inline static constinit std::atomic<instrument_thread_stats*> threads = nullptr;
+  inline static constinit thread_local instrument_thread_stats* local = nullptr;
+  inline static constinit instrument_entry entry{Tag::name, &stats};
+  inline static const bool registered = instrument_register(entry);
+};
+
+template <bool Enabled, function auto F, typename Tag>
+struct instrument_if {
+  static inline constexpr auto value = F;
+  static inline constexpr auto stats = +[]() noexcept { return instrument_stats{}; };
+};
+template <function auto F, typename Tag>
+struct instrument_if<true, F, Tag> {
+  using impl = instrument_f<F, Tag, parameter_types_of<decltype(F)>>;
+  static inline constexpr auto value = &impl::f;
+  static inline constexpr auto stats = &impl::stats;
+};
+}  // namespace detail
+
+template <function auto F, instrument_tag Tag>
+inline constexpr auto instrument =
+    detail::instrument_if<detail::instrument_enabled<Tag>(), unwrap<F>, Tag>::value;
+
+template <function auto F, instrument_tag Tag>
+inline constexpr auto instrument_stats_of =
+    detail::instrument_if<detail::instrument_enabled<Tag>(), unwrap<F>, Tag>::stats;
+
+// Returns the name and current stats of every instrumented function in the program (in no
+// particular order). Functions are registered during static initialization.
+inline std::vector<instrument_info> instrumented() {
+  std::vector<instrument_info> result;
+  for (auto* entry = detail::instrument_registry.load(std::memory_order_acquire); entry;
+       entry = entry->next) {
+    result.push_back({entry->name, entry->stats()});
+  }
+  return result;
+}
+
+}  // namespace sfn
+
+#endif
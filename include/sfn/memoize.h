@@ -0,0 +1,265 @@
+#ifndef STATIC_FUNCTIONAL_INCLUDE_SFN_MEMOIZE_H
+#define STATIC_FUNCTIONAL_INCLUDE_SFN_MEMOIZE_H
+#include <sfn/functional.h>
+#include <sfn/type_list.h>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <type_traits>
+
+namespace sfn {
+//-------------------------------------------------------------------------------------------------
+// memoize
+//-------------------------------------------------------------------------------------------------
+enum class memoize_eviction {
+  kClock,
+  kLru,
+};
+
+struct memoize_stats {
+  std::uint64_t hits = 0;
+  std::uint64_t misses = 0;
+};
+
+namespace detail {
+template <typename T>
+concept memoize_key = !std::is_reference_v<T> && std::is_trivially_copyable_v<T> &&
+    std::equality_comparable<T> && requires(const T& value) {
+  { std::hash<T>{}(value) } -> std::convertible_to<std::size_t>;
+};
+template <typename... Args>
+constexpr bool all_memoize_keys(list<Args...>) {
+  return (memoize_key<Args> && ...);
+}
+
+// Entries are stored as arrays of atomic words, so that readers can copy them without locking and
+// without data races, then check the slot's version to detect concurrent writes (a seqlock). Words
+// are stored with release and loaded with acquire ordering, so that a reader which sees any word of
+// a newer write also sees the odd version written before it; on x86 these are plain moves.
+template <typename T>
+inline constexpr std::size_t memoize_words = (sizeof(T) + sizeof(std::uint64_t) - 1u) /
+    sizeof(std::uint64_t);
+
+template <typename T>
+inline void memoize_store(const T& value, std::atomic<std::uint64_t>* out) noexcept {
+  std::uint64_t words[memoize_words<T>] = {};
+  std::memcpy(words, &value, sizeof(T));
+  for (std::size_t i = 0; i < memoize_words<T>; ++i) {
+    out[i].store(words[i], std::memory_order_release);
+  }
+}
+
+template <typename T>
+inline T memoize_load(const std::uint64_t* in) noexcept {
+  alignas(T) unsigned char bytes[sizeof(T)];
+  std::memcpy(bytes, in, sizeof(T));
+  return *std::launder(reinterpret_cast<T*>(bytes));
+}
+
+inline std::size_t memoize_hash_combine(std::size_t seed, std::size_t hash) noexcept {
+  return seed ^ (hash + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+}
+
+// Hit and miss counters are striped across cache lines by thread, and summed on demand.
+inline constexpr std::size_t memoize_stripes = 16;
+inline std::size_t memoize_stripe() noexcept {
+  static std::atomic<std::size_t> next = 0;
+  thread_local std::size_t stripe = next.fetch_add(1u, std::memory_order_relaxed) % memoize_stripes;
+  return stripe;
+}
+
+struct alignas(64) memoize_counters {
+  std::atomic<std::uint64_t> hits = 0;
+  std::atomic<std::uint64_t> misses = 0;
+};
+
+template <memoize_eviction Eviction, std::size_t Capacity, typename R, typename... Args>
+class memoize_cache {
+public:
+  // Returns true and sets result if the arguments are cached.
+  bool find(const Args&... args, std::size_t hash, R& result) noexcept {
+    auto set = hash % sets;
+    for (std::size_t way = 0; way < ways; ++way) {
+      auto& s = slots_[set * ways + way];
+      auto version = s.version.load(std::memory_order_acquire);
+      if (!version || version % 2u) {
+        continue;
+      }
+      std::uint64_t words[word_count];
+      for (std::size_t i = 0; i < word_count; ++i) {
+        words[i] = s.words[i].load(std::memory_order_acquire);
+      }
+      if (s.version.load(std::memory_order_relaxed) != version || !matches(words, args...)) {
+        continue;
+      }
+      if constexpr (Eviction == memoize_eviction::kLru) {
+        s.stamp.store(tick_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+      } else if (!s.stamp.load(std::memory_order_relaxed)) {
+        s.stamp.store(1u, std::memory_order_relaxed);
+      }
+      result = memoize_load<R>(words + result_offset);
+      return true;
+    }
+    return false;
+  }
+
+  // Inserts the result. If another thread is writing the chosen slot, the result isn't cached.
+  void insert(const Args&... args, std::size_t hash, const R& result) noexcept {
+    auto set = hash % sets;
+    auto& s = slots_[set * ways + victim(set)];
+    auto version = s.version.load(std::memory_order_relaxed);
+    if (version % 2u ||
+        !s.version.compare_exchange_strong(version, version + 1u, std::memory_order_relaxed)) {
+      return;
+    }
+    store_key(s.words, args...);
+    memoize_store(result, s.words + result_offset);
+    if constexpr (Eviction == memoize_eviction::kLru) {
+      s.stamp.store(tick_.fetch_add(1u, std::memory_order_relaxed) + 1u,
+                    std::memory_order_relaxed);
+    } else {
+      s.stamp.store(1u, std::memory_order_relaxed);
+    }
+    s.version.store(version + 2u, std::memory_order_release);
+  }
+
+  memoize_counters& counters() noexcept {
+    return counters_[memoize_stripe()];
+  }
+
+  memoize_stats stats() const noexcept {
+    memoize_stats result;
+    for (const auto& c : counters_) {
+      result.hits += c.hits.load(std::memory_order_relaxed);
+      result.misses += c.misses.load(std::memory_order_relaxed);
+    }
+    return result;
+  }
+
+private:
+  // Capacities above 4 are rounded up to a whole number of sets.
+  inline static constexpr std::size_t ways = Capacity < 4u ? Capacity : 4u;
+  inline static constexpr std::size_t sets = (Capacity + ways - 1u) / ways;
+  inline static constexpr std::size_t key_words[] = {memoize_words<Args>..., 0u};
+  inline static constexpr std::size_t result_offset = (memoize_words<Args> + ... + 0u);
+  inline static constexpr std::size_t word_count = result_offset + memoize_words<R>;
+
+  static constexpr std::size_t key_offset(std::size_t index) noexcept {
+    std::size_t offset = 0;
+    for (std::size_t i = 0; i < index; ++i) {
+      offset += key_words[i];
+    }
+    return offset;
+  }
+
+  struct slot {
+    // Zero if empty; odd while being written.
+    std::atomic<std::uint32_t> version = 0;
+    // Last use for LRU; reference bit for CLOCK.
+    std::atomic<std::uint32_t> stamp = 0;
+    std::atomic<std::uint64_t> words[word_count];
+  };
+
+  template <std::size_t... I>
+  static bool matches_impl(const std::uint64_t* words, std::index_sequence<I...>,
+                           const Args&... args) noexcept {
+    return ((memoize_load<Args>(words + key_offset(I)) == args) && ...);
+  }
+  static bool matches(const std::uint64_t* words, const Args&... args) noexcept {
+    return matches_impl(words, std::index_sequence_for<Args...>{}, args...);
+  }
+
+  static void store_key([[maybe_unused]] std::atomic<std::uint64_t>* words,
+                        const Args&... args) noexcept {
+    ((memoize_store(args, words), words += memoize_words<Args>), ...);
+  }
+
+  std::size_t victim(std::size_t set) noexcept {
+    auto* first = &slots_[set * ways];
+    for (std::size_t way = 0; way < ways; ++way) {
+      if (!first[way].version.load(std::memory_order_relaxed)) {
+        return way;
+      }
+    }
+    if constexpr (Eviction == memoize_eviction::kLru) {
+      // Compare ages rather than stamps so that the tick counter can wrap around.
+      auto now = tick_.load(std::memory_order_relaxed);
+      std::size_t oldest = 0;
+      for (std::size_t way = 1; way < ways; ++way) {
+        if (now - first[way].stamp.load(std::memory_order_relaxed) >
+            now - first[oldest].stamp.load(std::memory_order_relaxed)) {
+          oldest = way;
+        }
+      }
+      return oldest;
+    } else {
+      auto& hand = hands_[set];
+      for (std::size_t i = 0; i < 2u * ways; ++i) {
+        auto way = hand.fetch_add(1u, std::memory_order_relaxed) % ways;
+        if (!first[way].stamp.exchange(0u, std::memory_order_relaxed)) {
+          return way;
+        }
+      }
+      return hand.load(std::memory_order_relaxed) % ways;
+    }
+  }
+
+  slot slots_[sets * ways];
+  std::atomic<std::uint32_t> hands_[Eviction == memoize_eviction::kClock ? sets : 1u] = {};
+  std::atomic<std::uint32_t> tick_ = 0;
+  memoize_counters counters_[memoize_stripes];
+};
+
+template <function auto F, std::size_t Capacity, memoize_eviction Eviction, typename R, type_list>
+struct memoize_f;
+template <function auto F, std::size_t Capacity, memoize_eviction Eviction, typename R,
+          typename... Args>
+struct memoize_f<F, Capacity, Eviction, R, list<Args...>> {
+  inline static memoize_cache<Eviction, Capacity, R, Args...> cache;
+
+  inline static R f(Args... args) noexcept(noexcept(F(args...))) {
+    std::size_t hash = 0;
+    ((hash = memoize_hash_combine(hash, std::hash<Args>{}(args))), ...);
+    R result;
+    if (cache.find(args..., hash, result)) {
+      cache.counters().hits.fetch_add(1u, std::memory_order_relaxed);
+      return result;
+    }
+    cache.counters().misses.fetch_add(1u, std::memory_order_relaxed);
+    result = F(args...);
+    cache.insert(args..., hash, result);
+    return result;
+  }
+
+  inline static memoize_stats stats() noexcept {
+    return cache.stats();
+  }
+};
+}  // namespace detail
+
+template <typename T>
+concept memoizable = functional<T> && !std::is_void_v<return_type_of<T>> &&
+    detail::memoize_key<return_type_of<T>> && std::is_default_constructible_v<return_type_of<T>> &&
+    detail::all_memoize_keys(parameter_types_of<T>{});
+
+template <function auto F, std::size_t Capacity,
+          memoize_eviction Eviction = memoize_eviction::kClock>
+requires memoizable<decltype(F)> &&(Capacity > 0u)
+inline constexpr auto memoize =
+    &detail::memoize_f<unwrap<F>, Capacity, Eviction, return_type_of<decltype(F)>,
+                       parameter_types_of<decltype(F)>>::f;
+
+template <function auto F, std::size_t Capacity,
+          memoize_eviction Eviction = memoize_eviction::kClock>
+requires memoizable<decltype(F)> &&(Capacity > 0u)
+inline constexpr auto memoize_stats_of =
+    &detail::memoize_f<unwrap<F>, Capacity, Eviction, return_type_of<decltype(F)>,
+                       parameter_types_of<decltype(F)>>::stats;
+
+}  // namespace sfn
+
+#endif
@@ -0,0 +1,192 @@
+#ifndef STATIC_FUNCTIONAL_INCLUDE_SFN_MULTIVERSION_H
+#define STATIC_FUNCTIONAL_INCLUDE_SFN_MULTIVERSION_H
+#include <sfn/functional.h>
+#include <sfn/type_list.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#define STATIC_FUNCTIONAL_MULTIVERSION_X86
+#endif
+
+namespace sfn {
+//-------------------------------------------------------------------------------------------------
+// multiversion
+//-------------------------------------------------------------------------------------------------
+// Instruction set levels which a multiversioned function can have variants for. avx2 requires
+// AVX, AVX2, FMA, BMI1 and BMI2 (roughly x86-64-v3); avx512 additionally requires AVX-512 F, CD,
+// BW, DQ and VL (roughly x86-64-v4). Both also require the OS to save the extended registers.
+enum class cpu_level : unsigned { baseline, avx2, avx512 };
+
+namespace detail {
+#ifdef STATIC_FUNCTIONAL_MULTIVERSION_X86
+struct cpuid_registers {
+  std::uint32_t eax = 0;
+  std::uint32_t ebx = 0;
+  std::uint32_t ecx = 0;
+  std::uint32_t edx = 0;
+};
+
+inline cpuid_registers cpuid(std::uint32_t leaf, std::uint32_t subleaf) noexcept {
+  cpuid_registers r;
+#if defined(_MSC_VER) && !defined(__clang__)
+  int info[4];
+  __cpuidex(info, static_cast<int>(leaf), static_cast<int>(subleaf));
+  r = {static_cast<std::uint32_t>(info[0]), static_cast<std::uint32_t>(info[1]),
+       static_cast<std::uint32_t>(info[2]), static_cast<std::uint32_t>(info[3])};
+#else
+  __cpuid_count(leaf, subleaf, r.eax, r.ebx, r.ecx, r.edx);
+#endif
+  return r;
+}
+
+// Register state enabled by the OS (XCR0). Only valid if cpuid reports OSXSAVE.
+inline std::uint64_t xgetbv() noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+  return _xgetbv(0);
+#else
+  std::uint32_t eax = 0;
+  std::uint32_t edx = 0;
+  __asm__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0u));
+  return (static_cast<std::uint64_t>(edx) << 32u) | eax;
+#endif
+}
+#endif
+
+inline cpu_level cpu_level_uncached() noexcept {
+#ifdef STATIC_FUNCTIONAL_MULTIVERSION_X86
+  auto has = [](std::uint32_t reg, std::uint32_t bits) { return (reg & bits) == bits; };
+  if (cpuid(0u, 0u).eax < 7u) {
+    return cpu_level::baseline;
+  }
+  auto leaf1 = cpuid(1u, 0u);
+  auto leaf7 = cpuid(7u, 0u);
+  // Leaf 1 ECX: FMA, OSXSAVE, AVX. Leaf 7 EBX: BMI1, AVX2, BMI2.
+  if (!has(leaf1.ecx, (1u << 12u) | (1u << 27u) | (1u << 28u)) ||
+      !has(leaf7.ebx, (1u << 3u) | (1u << 5u) | (1u << 8u))) {
+    return cpu_level::baseline;
+  }
+  // XCR0: SSE and AVX state, then opmask and both halves of the upper ZMM state.
+  auto xcr0 = xgetbv();
+  if ((xcr0 & 0x6u) != 0x6u) {
+    return cpu_level::baseline;
+  }
+  // Leaf 7 EBX: AVX512F, AVX512DQ, AVX512CD, AVX512BW, AVX512VL.
+  if ((xcr0 & 0xe6u) != 0xe6u ||
+      !has(leaf7.ebx, (1u << 16u) | (1u << 17u) | (1u << 28u) | (1u << 30u) | (1u << 31u))) {
+    return cpu_level::avx2;
+  }
+  return cpu_level::avx512;
+#else
+  return cpu_level::baseline;
+#endif
+}
+}  // namespace detail
+
+// The instruction set level of the current CPU, detected once.
+inline cpu_level detected_cpu_level() noexcept {
+  static const cpu_level level = detail::cpu_level_uncached();
+  return level;
+}
+
+namespace detail {
+// Variants are given best first, so variant I of N targets level N - 1 - I.
+template <std::size_t N>
+inline std::size_t multiversion_best() noexcept {
+  auto level = static_cast<std::size_t>(detected_cpu_level());
+  return level < N ? N - 1u - level : 0u;
+}
+
+template <function_type T, type_list, function auto... F>
+struct multiversion_f;
+template <function_type T, typename... Args, function auto... F>
+struct multiversion_f<T, list<Args...>, F...> {
+  inline static constexpr ptr<T> variants[] = {cast<T, F>...};
+
+  // Selects the best variant, unless one has already been selected (by an earlier call or by
+  // multiversion_select), so that static initialization doesn't override an explicit choice.
+  static void resolve() noexcept {
+    ptr<T> expected = &first_call;
+    target.compare_exchange_strong(expected, variants[multiversion_best<sizeof...(F)>()],
+                                   std::memory_order_relaxed);
+  }
+
+  // The target starts out pointing here, so a call before static initialization has selected the
+  // best variant (e.g. from another static initializer) still ends up at the right place.
+  inline static decltype(auto) first_call(Args... args) noexcept(
+      (noexcept(cast<T, F>(maybe_move<Args>(args)...)) && ...)) {
+    resolve();
+    return target.load(std::memory_order_relaxed)(maybe_move<Args>(args)...);
+  }
+
+  STATIC_FUNCTIONAL_FUSE inline static decltype(auto) f(Args... args) noexcept(
+      (noexcept(cast<T, F>(maybe_move<Args>(args)...)) && ...)) {
+    (void)resolved;
+    return target.load(std::memory_order_relaxed)(maybe_move<Args>(args)...);
+  }
+
+  // The index is derived from the target rather than stored next to it, so that it can't be
+  // observed out of sync with it. Identical variants are reported as the first of them.
+  inline static std::size_t get_selected() noexcept {
+    resolve();
+    auto current = target.load(std::memory_order_relaxed);
+    std::size_t index = 0;
+    while (index + 1u < sizeof...(F) && variants[index] != current) {
+      ++index;
+    }
+    return index;
+  }
+  inline static bool set_selected(std::size_t index) noexcept {
+    if (index >= sizeof...(F)) {
+      return false;
+    }
+    target.store(variants[index], std::memory_order_relaxed);
+    return true;
+  }
+  inline static void reset() noexcept {
+    target.store(variants[multiversion_best<sizeof...(F)>()], std::memory_order_relaxed);
+  }
+
+  inline static constinit std::atomic<ptr<T>> target = &first_call;
+  inline static const bool resolved = (resolve(), true);
+};
+
+template <function auto F, function auto... Rest>
+using multiversion_impl =
+    multiversion_f<function_type_of<decltype(F)>, parameter_types_of<decltype(F)>, F, Rest...>;
+}  // namespace detail
+
+template <typename T, typename... Rest>
+concept multiversionable = sizeof...(Rest) < 3u && dispatchable<T, Rest...>;
+
+// Calls the variant for the best instruction set level supported by the CPU, e.g.
+// multiversion<&f_avx512, &f_avx2, &f_scalar>. With N variants, the last targets the baseline,
+// the one before it AVX2, and so on.
+template <function auto F, function auto... Rest>
+requires multiversionable<decltype(F), decltype(Rest)...>
+inline constexpr auto multiversion = &detail::multiversion_impl<F, Rest...>::f;
+
+// Returns the index of the variant in use, or overrides it (returning false if the index is out
+// of range), for testing each variant on a single machine. multiversion_reset goes back to the
+// best supported variant.
+template <function auto F, function auto... Rest>
+requires multiversionable<decltype(F), decltype(Rest)...>
+inline constexpr auto multiversion_selected = &detail::multiversion_impl<F, Rest...>::get_selected;
+
+template <function auto F, function auto... Rest>
+requires multiversionable<decltype(F), decltype(Rest)...>
+inline constexpr auto multiversion_select = &detail::multiversion_impl<F, Rest...>::set_selected;
+
+template <function auto F, function auto... Rest>
+requires multiversionable<decltype(F), decltype(Rest)...>
+inline constexpr auto multiversion_reset = &detail::multiversion_impl<F, Rest...>::reset;
+
+}  // namespace sfn
+
+#endif
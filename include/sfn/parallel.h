@@ -0,0 +1,394 @@
+#ifndef STATIC_FUNCTIONAL_INCLUDE_SFN_PARALLEL_H
+#define STATIC_FUNCTIONAL_INCLUDE_SFN_PARALLEL_H
+#include <sfn/functional.h>
+#include <sfn/type_list.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+// Number of pool threads, including the calling thread. Defaults to the hardware concurrency.
+#ifndef STATIC_FUNCTIONAL_PARALLEL_THREADS
+#define STATIC_FUNCTIONAL_PARALLEL_THREADS std::thread::hardware_concurrency()
+#endif
+
+// Maximum number of queued tasks per pool thread in each thread's deque. Once a deque is this full,
+// forked tasks are run inline on the calling thread instead.
+#ifndef STATIC_FUNCTIONAL_PARALLEL_QUEUE_DEPTH
+#define STATIC_FUNCTIONAL_PARALLEL_QUEUE_DEPTH 4
+#endif
+
+namespace sfn {
+//-------------------------------------------------------------------------------------------------
+// thread_pool
+//-------------------------------------------------------------------------------------------------
+namespace detail {
+struct pool_task {
+  void (*run)(void*);
+  void* context;
+  std::exception_ptr error = nullptr;
+  std::atomic<std::size_t>* pending = nullptr;
+};
+
+// Work-stealing pool: each pool thread has its own deque, which it pushes to and pops from at the
+// back; idle threads steal from the front of other deques. Threads outside the pool share deque 0.
+class thread_pool {
+public:
+  // Started lazily on first use.
+  static thread_pool& get() {
+    static thread_pool pool;
+    return pool;
+  }
+
+  ~thread_pool() {
+    {
+      std::lock_guard lock{sleep_mutex_};
+      stop_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  std::size_t size() const noexcept {
+    return threads_.size();
+  }
+
+  // Pushes the tasks in order onto the calling thread's deque; any that don't fit are run on the
+  // calling thread immediately.
+  void fork(pool_task* tasks, std::size_t n, std::atomic<std::size_t>& pending) {
+    pending.store(n, std::memory_order_relaxed);
+    auto& queue = queues_[current_queue];
+    std::size_t queued = 0;
+    {
+      std::lock_guard lock{queue.mutex};
+      for (; queued < n && queue.tasks.size() < limit_; ++queued) {
+        tasks[queued].pending = &pending;
+        queue.tasks.push_back(&tasks[queued]);
+        queued_.fetch_add(1u, std::memory_order_release);
+      }
+    }
+    if (queued) {
+      std::lock_guard lock{sleep_mutex_};
+      if (queued == 1u) {
+        work_cv_.notify_one();
+      } else {
+        work_cv_.notify_all();
+      }
+    }
+    for (std::size_t i = queued; i < n; ++i) {
+      tasks[i].pending = &pending;
+      execute(tasks[i]);
+    }
+  }
+
+  // Waits until all tasks from the corresponding fork have finished, running or stealing queued
+  // tasks on the calling thread in the meantime so that nested forks from pool threads can't
+  // deadlock.
+  void join(std::atomic<std::size_t>& pending) {
+    while (pending.load(std::memory_order_acquire)) {
+      if (auto* task = find(current_queue)) {
+        execute(*task);
+        continue;
+      }
+      std::unique_lock lock{sleep_mutex_};
+      done_cv_.wait(lock, [&] { return !pending.load(std::memory_order_acquire); });
+    }
+  }
+
+private:
+  struct alignas(64) queue {
+    std::mutex mutex;
+    std::deque<pool_task*> tasks;
+  };
+
+  thread_pool() {
+    unsigned n = STATIC_FUNCTIONAL_PARALLEL_THREADS;
+    queue_count_ = n ? n : 1u;
+    queues_ = std::make_unique<queue[]>(queue_count_);
+    limit_ = (queue_count_ - 1u) * STATIC_FUNCTIONAL_PARALLEL_QUEUE_DEPTH;
+    try {
+      for (unsigned i = 1; i < n; ++i) {
+        threads_.emplace_back([this, i] { work(i); });
+      }
+    } catch (const std::system_error&) {
+      // Run with however many threads we managed to start.
+    }
+    if (threads_.empty()) {
+      limit_ = 0;
+    }
+  }
+
+  pool_task* find(std::size_t index) {
+    pool_task* task = nullptr;
+    {
+      auto& own = queues_[index];
+      std::lock_guard lock{own.mutex};
+      if (!own.tasks.empty()) {
+        task = own.tasks.back();
+        own.tasks.pop_back();
+      }
+    }
+    for (std::size_t i = 1; !task && i < queue_count_; ++i) {
+      auto& other = queues_[(index + i) % queue_count_];
+      std::lock_guard lock{other.mutex};
+      if (!other.tasks.empty()) {
+        task = other.tasks.front();
+        other.tasks.pop_front();
+      }
+    }
+    if (task) {
+      queued_.fetch_sub(1u, std::memory_order_relaxed);
+    }
+    return task;
+  }
+
+  void execute(pool_task& task) {
+    try {
+      task.run(task.context);
+    } catch (...) {
+      task.error = std::current_exception();
+    }
+    // The task and counter live on the joining thread's stack, and may be gone as soon as the
+    // count reaches zero.
+    if (task.pending->fetch_sub(1u, std::memory_order_acq_rel) == 1u) {
+      std::lock_guard lock{sleep_mutex_};
+      done_cv_.notify_all();
+    }
+  }
+
+  void work(std::size_t index) {
+    current_queue = index;
+    while (true) {
+      if (auto* task = find(index)) {
+        execute(*task);
+        continue;
+      }
+      std::unique_lock lock{sleep_mutex_};
+      work_cv_.wait(lock, [this] { return stop_ || queued_.load(std::memory_order_acquire); });
+      if (stop_) {
+        return;
+      }
+    }
+  }
+
+  inline static thread_local std::size_t current_queue = 0;
+  std::size_t queue_count_ = 0;
+  std::unique_ptr<queue[]> queues_;
+  std::vector<std::thread> threads_;
+  std::size_t limit_ = 0;
+  std::atomic<std::size_t> queued_ = 0;
+  std::mutex sleep_mutex_;
+  std::condition_variable work_cv_;
+  std::condition_variable done_cv_;
+  bool stop_ = false;
+};
+
+// Forks tasks on construction. finish() joins them and rethrows the exception from the first task
+// (in order) that threw, if any.
+class fork_join {
+public:
+  fork_join(pool_task* tasks, std::size_t n) : tasks_{tasks}, n_{n} {
+    thread_pool::get().fork(tasks, n, pending_);
+  }
+  ~fork_join() {
+    if (!joined_) {
+      thread_pool::get().join(pending_);
+    }
+  }
+  fork_join(const fork_join&) = delete;
+  fork_join& operator=(const fork_join&) = delete;
+
+  void finish() {
+    if (joined_) {
+      return;
+    }
+    thread_pool::get().join(pending_);
+    joined_ = true;
+    for (std::size_t i = 0; i < n_; ++i) {
+      if (tasks_[i].error) {
+        std::rethrow_exception(tasks_[i].error);
+      }
+    }
+  }
+
+private:
+  pool_task* tasks_;
+  std::size_t n_;
+  std::atomic<std::size_t> pending_ = 0;
+  bool joined_ = false;
+};
+}  // namespace detail
+
+//-------------------------------------------------------------------------------------------------
+// parallel_sequence
+//-------------------------------------------------------------------------------------------------
+namespace detail {
+template <typename, function auto... F>
+struct parallel_sequence_f;
+template <typename... Args, function auto... F>
+struct parallel_sequence_f<list<Args...>, F...> {
+  inline static constexpr auto last = std::get<sizeof...(F) - 1u>(std::tuple{F...});
+
+  template <function auto G>
+  static void run(void* args) {
+    std::apply(G, *static_cast<std::tuple<Args&...>*>(args));
+  }
+
+  inline static decltype(auto) f(Args... args) noexcept(noexcept((F(args...), ...))) {
+    std::tuple<Args&...> refs{args...};
+    pool_task tasks[] = {{&run<F>, &refs}...};
+    fork_join join{tasks, sizeof...(F) - 1u};
+    if constexpr (noexcept((F(args...), ...))) {
+      return call_last(join, args...);
+    } else {
+      try {
+        return call_last(join, args...);
+      } catch (...) {
+        join.finish();
+        throw;
+      }
+    }
+  }
+
+private:
+  inline static decltype(auto) call_last(fork_join& join, Args&... args) {
+    if constexpr (std::is_void_v<decltype(last(args...))>) {
+      last(args...);
+      join.finish();
+    } else {
+      decltype(auto) result = last(args...);
+      join.finish();
+      return result;
+    }
+  }
+};
+}  // namespace detail
+
+template <function auto F, function auto... Rest>
+requires sequencable<decltype(F), decltype(Rest)...>
+inline constexpr auto parallel_sequence =
+    &detail::parallel_sequence_f<parameter_types_of<decltype(F)>, unwrap<F>, unwrap<Rest>...>::f;
+
+template <function auto F>
+requires sequencable<decltype(F)>
+inline constexpr auto parallel_sequence<F> = F;
+
+//-------------------------------------------------------------------------------------------------
+// parallel_batch
+//-------------------------------------------------------------------------------------------------
+// Target duration of each chunk of a parallel_batch, in nanoseconds.
+#ifndef STATIC_FUNCTIONAL_PARALLEL_CHUNK_NS
+#define STATIC_FUNCTIONAL_PARALLEL_CHUNK_NS 50000
+#endif
+
+namespace detail {
+// Splits [begin, end) in half until it's at most grain elements, forking the right half each time.
+template <typename Body>
+void parallel_for(std::size_t begin, std::size_t end, std::size_t grain, const Body& body) {
+  if (end - begin <= grain) {
+    body(begin, end);
+    return;
+  }
+  struct range {
+    std::size_t begin;
+    std::size_t end;
+    std::size_t grain;
+    const Body* body;
+  } right{begin + (end - begin) / 2u, end, grain, &body};
+  pool_task task{[](void* context) {
+                   auto& r = *static_cast<range*>(context);
+                   parallel_for(r.begin, r.end, r.grain, *r.body);
+                 },
+                 &right};
+  fork_join join{&task, 1u};
+  parallel_for(begin, right.begin, grain, body);
+  join.finish();
+}
+
+// Runs body over [0, n) in chunks sized from the measured cost per element, which is remembered
+// across calls in cost_ps. The first call measures it by running geometrically growing chunks on
+// the calling thread.
+template <typename Body>
+void adaptive_for(std::atomic<std::uint64_t>& cost_ps, std::size_t n, const Body& body) {
+  constexpr std::uint64_t target_ps = std::uint64_t{STATIC_FUNCTIONAL_PARALLEL_CHUNK_NS} * 1000u;
+  auto timed_body = [&](std::size_t begin, std::size_t end) {
+    auto start = std::chrono::steady_clock::now();
+    body(begin, end);
+    auto ps = std::chrono::duration_cast<std::chrono::duration<std::uint64_t, std::pico>>(
+                  std::chrono::steady_clock::now() - start)
+                  .count();
+    cost_ps.store(ps / (end - begin) + 1u, std::memory_order_relaxed);
+    return ps;
+  };
+
+  std::size_t i = 0;
+  if (!cost_ps.load(std::memory_order_relaxed)) {
+    for (std::size_t k = 1; i < n; k *= 2u) {
+      auto end = n - i < k ? n : i + k;
+      auto ps = timed_body(i, end);
+      i = end;
+      if (ps >= target_ps / 16u) {
+        break;
+      }
+    }
+  }
+  if (i == n) {
+    return;
+  }
+  auto grain = target_ps / cost_ps.load(std::memory_order_relaxed);
+  if (!thread_pool::get().size() || n - i <= grain) {
+    body(i, n);
+    return;
+  }
+  parallel_for(i, n, grain ? grain : 1u, timed_body);
+}
+
+template <function auto F, typename R, type_list>
+struct parallel_batch_f;
+template <function auto F, typename R, typename... Args>
+struct parallel_batch_f<F, R, list<Args...>> {
+  inline static std::atomic<std::uint64_t> cost_ps = 0;
+
+  inline static void f(
+      batch_input<Args>* STATIC_FUNCTIONAL_RESTRICT... in,
+      batch_output<R>* STATIC_FUNCTIONAL_RESTRICT out,
+      std::size_t n) noexcept(noexcept(out[0] = F(batch_element<Args>(in, 0)...))) {
+    adaptive_for(cost_ps, n, [&](std::size_t begin, std::size_t end) {
+      batch_f<F, R, list<Args...>>::f(in + begin..., out + begin, end - begin);
+    });
+  }
+};
+template <function auto F, typename... Args>
+struct parallel_batch_f<F, void, list<Args...>> {
+  inline static std::atomic<std::uint64_t> cost_ps = 0;
+
+  inline static void f(batch_input<Args>* STATIC_FUNCTIONAL_RESTRICT... in,
+                       std::size_t n) noexcept(noexcept(F(batch_element<Args>(in, 0)...))) {
+    adaptive_for(cost_ps, n, [&](std::size_t begin, std::size_t end) {
+      batch_f<F, void, list<Args...>>::f(in + begin..., end - begin);
+    });
+  }
+};
+}  // namespace detail
+
+template <function auto F>
+requires batchable<decltype(F)>
+inline constexpr auto parallel_batch =
+    &detail::parallel_batch_f<unwrap<F>, return_type_of<decltype(F)>,
+                              parameter_types_of<decltype(F)>>::f;
+
+}  // namespace sfn
+
+#endif
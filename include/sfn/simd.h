@@ -0,0 +1,199 @@
+#ifndef STATIC_FUNCTIONAL_INCLUDE_SFN_SIMD_H
+#define STATIC_FUNCTIONAL_INCLUDE_SFN_SIMD_H
+#include <sfn/functional.h>
+#include <sfn/type_list.h>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#if defined(__has_include)
+#if __has_include(<experimental/simd>) && !defined(STATIC_FUNCTIONAL_PORTABLE_SIMD)
+#include <experimental/simd>
+#define STATIC_FUNCTIONAL_HAS_EXPERIMENTAL_SIMD
+#endif
+#endif
+
+namespace sfn {
+//-------------------------------------------------------------------------------------------------
+// simd
+//-------------------------------------------------------------------------------------------------
+namespace detail {
+template <typename T, std::size_t Width>
+struct portable_simd {
+  using value_type = T;
+  static constexpr std::size_t size() noexcept {
+    return Width;
+  }
+
+  portable_simd() = default;
+  template <typename U>
+  requires std::is_convertible_v<U, T>
+  constexpr portable_simd(U&& value) noexcept {
+    for (std::size_t i = 0; i < Width; ++i) {
+      lanes[i] = static_cast<T>(value);
+    }
+  }
+
+  constexpr T& operator[](std::size_t i) noexcept {
+    return lanes[i];
+  }
+  constexpr T operator[](std::size_t i) const noexcept {
+    return lanes[i];
+  }
+  constexpr portable_simd operator-() const noexcept {
+    portable_simd r;
+    for (std::size_t i = 0; i < Width; ++i) {
+      r.lanes[i] = -lanes[i];
+    }
+    return r;
+  }
+
+#define STATIC_FUNCTIONAL_PORTABLE_SIMD_OPERATOR(op)                                  \
+  constexpr portable_simd& operator op##=(const portable_simd& other) noexcept {      \
+    for (std::size_t i = 0; i < Width; ++i) {                                         \
+      lanes[i] op##= other.lanes[i];                                                  \
+    }                                                                                 \
+    return *this;                                                                     \
+  }                                                                                   \
+  friend constexpr portable_simd operator op(portable_simd a,                         \
+                                             const portable_simd& b) noexcept {       \
+    return a op##= b;                                                                 \
+  }
+  STATIC_FUNCTIONAL_PORTABLE_SIMD_OPERATOR(+)
+  STATIC_FUNCTIONAL_PORTABLE_SIMD_OPERATOR(-)
+  STATIC_FUNCTIONAL_PORTABLE_SIMD_OPERATOR(*)
+  STATIC_FUNCTIONAL_PORTABLE_SIMD_OPERATOR(/)
+#undef STATIC_FUNCTIONAL_PORTABLE_SIMD_OPERATOR
+
+  T lanes[Width];
+};
+
+template <typename>
+struct simd_traits {
+  inline static constexpr bool is_simd = false;
+  inline static constexpr std::size_t width = 0;
+  using value_type = void;
+};
+template <typename T, std::size_t Width>
+struct simd_traits<portable_simd<T, Width>> {
+  inline static constexpr bool is_simd = true;
+  inline static constexpr std::size_t width = Width;
+  using value_type = T;
+};
+#ifdef STATIC_FUNCTIONAL_HAS_EXPERIMENTAL_SIMD
+template <typename T, typename Abi>
+struct simd_traits<std::experimental::simd<T, Abi>> {
+  inline static constexpr bool is_simd = true;
+  inline static constexpr std::size_t width = std::experimental::simd<T, Abi>::size();
+  using value_type = T;
+};
+#endif
+
+template <typename V>
+inline V simd_load(const typename simd_traits<V>::value_type* p) noexcept {
+#ifdef STATIC_FUNCTIONAL_HAS_EXPERIMENTAL_SIMD
+  if constexpr (!std::is_same_v<V, portable_simd<typename V::value_type, V::size()>>) {
+    return V(p, std::experimental::element_aligned);
+  } else
+#endif
+  {
+    V v;
+    for (std::size_t i = 0; i < V::size(); ++i) {
+      v[i] = p[i];
+    }
+    return v;
+  }
+}
+
+template <typename V>
+inline void simd_store(const V& v, typename simd_traits<V>::value_type* p) noexcept {
+#ifdef STATIC_FUNCTIONAL_HAS_EXPERIMENTAL_SIMD
+  if constexpr (!std::is_same_v<V, portable_simd<typename V::value_type, V::size()>>) {
+    v.copy_to(p, std::experimental::element_aligned);
+  } else
+#endif
+  {
+    for (std::size_t i = 0; i < V::size(); ++i) {
+      p[i] = v[i];
+    }
+  }
+}
+}  // namespace detail
+
+#ifdef STATIC_FUNCTIONAL_HAS_EXPERIMENTAL_SIMD
+template <typename T, std::size_t Width>
+using simd = std::experimental::fixed_size_simd<T, Width>;
+#else
+template <typename T, std::size_t Width>
+using simd = detail::portable_simd<T, Width>;
+#endif
+
+template <typename T>
+concept simd_type = detail::simd_traits<std::remove_cvref_t<T>>::is_simd;
+
+//-------------------------------------------------------------------------------------------------
+// simd_map
+//-------------------------------------------------------------------------------------------------
+namespace detail {
+template <typename T>
+using simd_of = simd_traits<std::remove_cvref_t<T>>;
+
+template <typename... Args, typename... VArgs>
+constexpr bool all_simd_lanes_match(list<Args...>, list<VArgs...>, std::size_t width) {
+  return ((simd_type<VArgs> && !std::is_rvalue_reference_v<Args> &&
+           std::is_same_v<std::remove_cvref_t<Args>, typename simd_of<VArgs>::value_type> &&
+           simd_of<VArgs>::width == width) &&
+          ...);
+}
+
+template <functional F, functional VF>
+struct simd_map_impl {
+  using r = return_type_of<F>;
+  using vr = return_type_of<VF>;
+  inline static constexpr std::size_t width = simd_of<vr>::width;
+  inline static constexpr bool return_types_match =
+      simd_type<vr> && std::is_same_v<batch_output<r>, typename simd_of<vr>::value_type>;
+  inline static constexpr bool parameter_counts_match =
+      size<parameter_types_of<F>> == size<parameter_types_of<VF>>;
+  inline static constexpr bool parameter_types_match =
+      all_simd_lanes_match(parameter_types_of<F>{}, parameter_types_of<VF>{}, width);
+};
+
+template <function auto F, function auto VF, std::size_t Width, typename R, type_list, type_list>
+struct simd_map_f;
+template <function auto F, function auto VF, std::size_t Width, typename R, typename... Args,
+          typename... VArgs>
+struct simd_map_f<F, VF, Width, R, list<Args...>, list<VArgs...>> {
+  inline static void
+  f(batch_input<Args>* STATIC_FUNCTIONAL_RESTRICT... in,
+    batch_output<R>* STATIC_FUNCTIONAL_RESTRICT out,
+    std::size_t n) noexcept(noexcept(out[0] = F(batch_element<Args>(in, 0)...)) &&
+                            noexcept(VF(simd_load<std::remove_cvref_t<VArgs>>(in)...))) {
+    std::size_t i = 0;
+    for (; i + Width <= n; i += Width) {
+      simd_store(VF(simd_load<std::remove_cvref_t<VArgs>>(in + i)...), out + i);
+    }
+    for (; i < n; ++i) {
+      out[i] = F(batch_element<Args>(in, i)...);
+    }
+  }
+};
+}  // namespace detail
+
+template <typename F, typename VF>
+concept simd_mappable = batchable<F> && functional<VF> &&
+    detail::simd_map_impl<F, VF>::return_types_match &&
+    detail::simd_map_impl<F, VF>::parameter_counts_match &&
+    detail::simd_map_impl<F, VF>::parameter_types_match;
+
+template <function auto F, function auto VF>
+requires simd_mappable<decltype(F), decltype(VF)>
+inline constexpr auto simd_map =
+    &detail::simd_map_f<unwrap<F>, unwrap<VF>,
+                        detail::simd_map_impl<decltype(F), decltype(VF)>::width,
+                        return_type_of<decltype(F)>, parameter_types_of<decltype(F)>,
+                        parameter_types_of<decltype(VF)>>::f;
+
+}  // namespace sfn
+
+#endif
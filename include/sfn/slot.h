@@ -0,0 +1,229 @@
+#ifndef STATIC_FUNCTIONAL_INCLUDE_SFN_SLOT_H
+#define STATIC_FUNCTIONAL_INCLUDE_SFN_SLOT_H
+#include <sfn/functional.h>
+#include <sfn/type_list.h>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <thread>
+
+// On Linux, slot writers use membarrier so that readers don't need a fence. Define
+// STATIC_FUNCTIONAL_SLOT_NO_MEMBARRIER to use full fences on both sides instead.
+#if defined(__linux__) && !defined(STATIC_FUNCTIONAL_SLOT_NO_MEMBARRIER) && \
+    __has_include(<linux/membarrier.h>)
+#include <linux/membarrier.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define STATIC_FUNCTIONAL_SLOT_MEMBARRIER
+#endif
+
+namespace sfn {
+//-------------------------------------------------------------------------------------------------
+// slot
+//-------------------------------------------------------------------------------------------------
+namespace detail {
+// Each thread that calls through a slot has a reader record, which holds the epoch at which its
+// outermost slot call started (or 0 outside of any slot call). Records are shared by all slots,
+// and are reused by new threads after their thread exits, but never freed.
+struct slot_reader {
+  std::atomic<std::uint64_t> active = 0;
+  std::atomic<bool> in_use = true;
+  std::uint64_t nesting = 0;
+  slot_reader* next = nullptr;
+};
+
+struct slot_domain {
+  std::atomic<std::uint64_t> epoch = 1;
+  std::atomic<slot_reader*> readers = nullptr;
+};
+inline constinit slot_domain slot_global;
+
+// With membarrier, the writer forces a memory barrier on every running thread of the process, so
+// readers only need a compiler barrier; otherwise both sides use a full fence. Registration happens
+// during static initialization, before which both sides use full fences.
+inline bool slot_register_membarrier() noexcept {
+#ifdef STATIC_FUNCTIONAL_SLOT_MEMBARRIER
+  return !syscall(SYS_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0, 0);
+#else
+  return false;
+#endif
+}
+inline const bool slot_membarrier = slot_register_membarrier();
+
+inline void slot_reader_barrier() noexcept {
+  if (slot_membarrier) {
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+  } else {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  }
+}
+
+// Once registration has succeeded, readers rely on the membarrier and can't be switched back to
+// fences, so a local fence wouldn't order against them: if the membarrier then fails, this
+// terminates rather than letting a grace period end early.
+inline void slot_writer_barrier() noexcept {
+#ifdef STATIC_FUNCTIONAL_SLOT_MEMBARRIER
+  if (slot_membarrier) {
+    if (syscall(SYS_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0, 0)) {
+      std::terminate();
+    }
+    return;
+  }
+#endif
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+// Reuses the record of an exited thread if there is one, or else adds a new one. This only happens
+// on a thread's first slot call.
+inline slot_reader* slot_register_reader() {
+  auto* head = slot_global.readers.load(std::memory_order_acquire);
+  for (auto* r = head; r; r = r->next) {
+    bool expected = false;
+    if (!r->in_use.load(std::memory_order_relaxed) &&
+        r->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+      return r;
+    }
+  }
+  auto* r = new slot_reader;
+  do {
+    r->next = head;
+  } while (!slot_global.readers.compare_exchange_weak(head, r, std::memory_order_release,
+                                                     std::memory_order_acquire));
+  return r;
+}
+
+inline constinit thread_local slot_reader* slot_local_reader = nullptr;
+
+struct slot_reader_release {
+  ~slot_reader_release() {
+    slot_local_reader->active.store(0, std::memory_order_release);
+    slot_local_reader->in_use.store(false, std::memory_order_release);
+    slot_local_reader = nullptr;
+  }
+};
+
+inline slot_reader& slot_this_reader() {
+  if (!slot_local_reader) [[unlikely]] {
+    slot_local_reader = slot_register_reader();
+    thread_local slot_reader_release release;
+  }
+  return *slot_local_reader;
+}
+
+// Marks the calling thread as reading slot targets for its lifetime. Reads are wait-free: entering
+// and leaving are plain stores to the thread's own record (plus a compiler barrier, or a fence
+// without membarrier), and nested slot calls only count.
+struct slot_read_scope {
+  slot_reader& reader = slot_this_reader();
+
+  slot_read_scope() noexcept {
+    if (!reader.nesting++) {
+      reader.active.store(slot_global.epoch.load(std::memory_order_relaxed),
+                          std::memory_order_release);
+      slot_reader_barrier();
+    }
+  }
+  ~slot_read_scope() {
+    if (!--reader.nesting) {
+      reader.active.store(0, std::memory_order_release);
+    }
+  }
+};
+
+// Starts a grace period after a new target has been stored. Readers that might still be using the
+// old target are those whose outermost slot call started before the returned epoch.
+inline std::uint64_t slot_retire() noexcept {
+  slot_writer_barrier();
+  return slot_global.epoch.fetch_add(1u, std::memory_order_seq_cst) + 1u;
+}
+
+inline bool slot_quiesced(std::uint64_t epoch) noexcept {
+  for (auto* r = slot_global.readers.load(std::memory_order_acquire); r; r = r->next) {
+    auto active = r->active.load(std::memory_order_acquire);
+    if (active && active < epoch) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <function_type Signature, type_list>
+struct slot_empty;
+template <function_type Signature, typename... Args>
+struct slot_empty<Signature, list<Args...>> {
+  [[noreturn]] inline static return_type_of<Signature> f(Args...) noexcept(is_noexcept<Signature>) {
+    if constexpr (is_noexcept<Signature>) {
+      std::terminate();
+    } else {
+      throw std::bad_function_call{};
+    }
+  }
+};
+
+template <function_type Signature, typename Tag, type_list>
+struct slot_f;
+template <function_type Signature, typename Tag, typename... Args>
+struct slot_f<Signature, Tag, list<Args...>> {
+  inline static constexpr ptr<Signature> empty = &slot_empty<Signature, list<Args...>>::f;
+
+  STATIC_FUNCTIONAL_FUSE inline static decltype(auto)
+  f(Args... args) noexcept(is_noexcept<Signature>) {
+    slot_read_scope scope;
+    return target.load(std::memory_order_acquire)(maybe_move<Args>(args)...);
+  }
+
+  inline static constinit std::atomic<ptr<Signature>> target = empty;
+};
+}  // namespace detail
+
+// The previous target of a slot, returned by swap. Once quiesced() returns true (or wait()
+// returns), no thread is still running it from a call through the slot, so it is safe to unload.
+template <function_type Signature>
+struct [[nodiscard]] slot_retired {
+  ptr<Signature> previous = nullptr;
+  std::uint64_t epoch = 0;
+
+  bool quiesced() const noexcept {
+    return detail::slot_quiesced(epoch);
+  }
+  // Must not be called from inside a slot call, which would wait for itself.
+  void wait() const noexcept {
+    while (!quiesced()) {
+      std::this_thread::yield();
+    }
+  }
+};
+
+// A function pointer which can be swapped at runtime while other threads call through it. Tag
+// distinguishes slots with the same signature. slot<Signature, Tag>::call is a function with the
+// given signature, which calls the current target; a slot is empty until its first swap, and
+// calling an empty slot throws std::bad_function_call (or terminates, if Signature is noexcept).
+template <function_type Signature, typename Tag = void>
+struct slot {
+  using impl = detail::slot_f<Signature, Tag, parameter_types_of<Signature>>;
+
+  inline static constexpr ptr<Signature> call = &impl::f;
+
+  static ptr<Signature> load() noexcept {
+    auto target = impl::target.load(std::memory_order_acquire);
+    return target == impl::empty ? nullptr : target;
+  }
+
+  // Stores a new target (or empties the slot, for nullptr) and starts a grace period for the old
+  // one.
+  static slot_retired<Signature> swap(ptr<Signature> target) noexcept {
+    auto previous = impl::target.exchange(target ? target : impl::empty, std::memory_order_acq_rel);
+    return {previous == impl::empty ? nullptr : previous, detail::slot_retire()};
+  }
+
+  template <function auto F>
+  requires castable_to<decltype(F), Signature>
+  static slot_retired<Signature> swap() noexcept {
+    return swap(cast<Signature, F>);
+  }
+};
+
+}  // namespace sfn
+
+#endif
@@ -0,0 +1,339 @@
+#ifndef STATIC_FUNCTIONAL_INCLUDE_SFN_STRING_DISPATCH_H
+#define STATIC_FUNCTIONAL_INCLUDE_SFN_STRING_DISPATCH_H
+#include <sfn/functional.h>
+#include <sfn/type_list.h>
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+namespace sfn {
+//-------------------------------------------------------------------------------------------------
+// string_dispatch / string_dispatch_or
+//-------------------------------------------------------------------------------------------------
+// A key and the function it maps to, e.g. entry<"get", &get>.
+template <string_literal Key, function auto F>
+struct entry {
+  inline static constexpr std::string_view key = Key.view();
+  inline static constexpr auto value = F;
+};
+
+namespace detail {
+template <typename T>
+struct is_entry : std::false_type {};
+template <std::size_t N, string_literal<N> Key, function auto F>
+struct is_entry<entry<Key, F>> : std::true_type {};
+}  // namespace detail
+
+template <typename T>
+concept string_entry = detail::is_entry<T>::value;
+
+namespace detail {
+// Every handler is cast to entry_type, and called through a function of the result type.
+template <typename R, type_list Args>
+struct string_dispatch_function;
+template <typename R, typename... Args>
+struct string_dispatch_function<R, list<Args...>> {
+  using entry_type = R(Args...);
+  using type = R(std::string_view, Args...);
+};
+
+template <string_entry Entry>
+using string_entry_function = std::remove_const_t<decltype(Entry::value)>;
+
+// N little-endian bytes, loaded with memcpy at runtime (a single unaligned load).
+template <std::size_t N>
+constexpr std::uint64_t string_dispatch_load(const char* p) noexcept {
+  if (!std::is_constant_evaluated() && std::endian::native == std::endian::little) {
+    std::conditional_t<N == 8u, std::uint64_t, std::uint32_t> word;
+    std::memcpy(&word, p, N);
+    return word;
+  }
+  std::uint64_t word = 0;
+  for (std::size_t i = 0; i < N; ++i) {
+    word |= std::uint64_t{static_cast<unsigned char>(p[i])} << (8u * i);
+  }
+  return word;
+}
+
+// Hashes a word at a time, with one multiply per 8 bytes. The last 1 to 8 bytes are read with
+// overlapping loads, so nothing past the end of the key is read. A 64-bit finalizer makes both the
+// low bits (which pick the slot) and the high bits (which pick the bucket) depend on every byte.
+constexpr std::uint64_t string_dispatch_hash(std::string_view s, std::uint64_t seed) noexcept {
+  constexpr std::uint64_t k = 0x9e3779b97f4a7c15u;
+  const char* p = s.data();
+  std::size_t n = s.size();
+  std::uint64_t h = (seed + 1u) * k ^ n;
+  auto mix = [&](std::uint64_t word) {
+    h = (h ^ word) * k;
+    h ^= h >> 32u;
+  };
+  for (; n > 8u; n -= 8u, p += 8u) {
+    mix(string_dispatch_load<8u>(p));
+  }
+  if (n >= 4u) {
+    mix(string_dispatch_load<4u>(p) | string_dispatch_load<4u>(p + n - 4u) << 32u);
+  } else if (n) {
+    mix(std::uint64_t{static_cast<unsigned char>(p[0])} << 16u |
+        std::uint64_t{static_cast<unsigned char>(p[n / 2u])} << 8u |
+        std::uint64_t{static_cast<unsigned char>(p[n - 1u])});
+  }
+  h ^= h >> 33u;
+  h *= 0xff51afd7ed558ccdu;
+  h ^= h >> 33u;
+  return h;
+}
+
+// Compares keys with the same loads as string_dispatch_hash, rather than calling memcmp.
+constexpr bool string_dispatch_equal(std::string_view a, std::string_view b) noexcept {
+  if (a.size() != b.size()) {
+    return false;
+  }
+  const char* p = a.data();
+  const char* q = b.data();
+  std::size_t n = a.size();
+  for (; n > 8u; n -= 8u, p += 8u, q += 8u) {
+    if (string_dispatch_load<8u>(p) != string_dispatch_load<8u>(q)) {
+      return false;
+    }
+  }
+  if (n >= 4u) {
+    return string_dispatch_load<4u>(p) == string_dispatch_load<4u>(q) &&
+        string_dispatch_load<4u>(p + n - 4u) == string_dispatch_load<4u>(q + n - 4u);
+  }
+  return !n || (p[0] == q[0] && p[n / 2u] == q[n / 2u] && p[n - 1u] == q[n - 1u]);
+}
+
+// A perfect hash table (hash and displace): the high bits of the hash pick a bucket, and the slot
+// is the low bits of the hash XORed with a displacement chosen for that bucket at compile time, so
+// that no two keys share a slot. At most half of the slots are used, and buckets have four keys
+// on average. Unused slots call the handler for unknown keys.
+template <function_type T, std::size_t N>
+struct string_dispatch_table {
+  inline static constexpr std::size_t slot_count = 2u * std::bit_ceil(N);
+  inline static constexpr std::size_t bucket_count = slot_count < 8u ? 1u : slot_count / 8u;
+
+  struct slot_type {
+    std::string_view key;
+    ptr<T> f = nullptr;
+  };
+
+  static constexpr std::size_t bucket(std::uint64_t hash) noexcept {
+    return static_cast<std::size_t>(hash >> 32u) & (bucket_count - 1u);
+  }
+  constexpr std::size_t slot(std::uint64_t hash) const noexcept {
+    return static_cast<std::size_t>(hash ^ displacement[bucket(hash)]) & (slot_count - 1u);
+  }
+  constexpr const slot_type& find(std::string_view key) const noexcept {
+    return slots[slot(string_dispatch_hash(key, seed))];
+  }
+
+  std::uint64_t seed = 0;
+  std::uint32_t displacement[bucket_count] = {};
+  slot_type slots[slot_count] = {};
+};
+
+// Places every key with the table's seed, largest buckets first while there is the most room.
+// Fails if two keys in the same bucket have the same slot bits, or a bucket doesn't fit.
+template <function_type T, std::size_t N>
+constexpr bool string_dispatch_place(string_dispatch_table<T, N>& table,
+                                     const std::string_view (&keys)[N],
+                                     const ptr<T> (&handlers)[N]) {
+  using table_type = string_dispatch_table<T, N>;
+  constexpr std::size_t mask = table_type::slot_count - 1u;
+  std::uint64_t hashes[N] = {};
+  std::size_t order[N] = {};
+  std::size_t start[table_type::bucket_count + 1u] = {};
+  std::size_t next[table_type::bucket_count] = {};
+  bool used[table_type::slot_count] = {};
+
+  for (std::size_t i = 0; i < N; ++i) {
+    hashes[i] = string_dispatch_hash(keys[i], table.seed);
+    ++start[table_type::bucket(hashes[i]) + 1u];
+  }
+  std::size_t largest = 0;
+  for (std::size_t b = 0; b < table_type::bucket_count; ++b) {
+    largest = std::max(largest, start[b + 1u]);
+    start[b + 1u] += start[b];
+    next[b] = start[b];
+  }
+  for (std::size_t i = 0; i < N; ++i) {
+    order[next[table_type::bucket(hashes[i])]++] = i;
+  }
+
+  for (std::size_t n = largest; n > 0u; --n) {
+    for (std::size_t b = 0; b < table_type::bucket_count; ++b) {
+      if (start[b + 1u] - start[b] != n) {
+        continue;
+      }
+      const std::size_t* members = order + start[b];
+      for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = i + 1u; j < n; ++j) {
+          if (!((hashes[members[i]] ^ hashes[members[j]]) & mask)) {
+            return false;
+          }
+        }
+      }
+      std::size_t d = 0;
+      for (; d < table_type::slot_count; ++d) {
+        bool fits = true;
+        for (std::size_t i = 0; i < n && fits; ++i) {
+          fits = !used[(hashes[members[i]] ^ d) & mask];
+        }
+        if (fits) {
+          break;
+        }
+      }
+      if (d == table_type::slot_count) {
+        return false;
+      }
+      table.displacement[b] = static_cast<std::uint32_t>(d);
+      for (std::size_t i = 0; i < n; ++i) {
+        auto s = (hashes[members[i]] ^ d) & mask;
+        used[s] = true;
+        table.slots[s] = {keys[members[i]], handlers[members[i]]};
+      }
+    }
+  }
+  return true;
+}
+
+// Tries successive seeds until every key has been placed. With distinct keys, this almost always
+// succeeds with the first few.
+template <function_type T, std::size_t N>
+constexpr string_dispatch_table<T, N>
+make_string_dispatch_table(const std::string_view (&keys)[N], const ptr<T> (&handlers)[N],
+                           std::type_identity_t<ptr<T>> unknown) {
+  for (std::uint64_t seed = 0;; ++seed) {
+    string_dispatch_table<T, N> table;
+    table.seed = seed;
+    for (auto& slot : table.slots) {
+      slot.f = unknown;
+    }
+    if (string_dispatch_place(table, keys, handlers)) {
+      return table;
+    }
+  }
+}
+
+template <typename... Entries>
+constexpr bool string_dispatch_unique() {
+  std::string_view keys[] = {Entries::key...};
+  std::sort(keys, keys + sizeof...(Entries));
+  return std::adjacent_find(keys, keys + sizeof...(Entries)) == keys + sizeof...(Entries);
+}
+
+template <typename T, typename... Entries>
+constexpr bool string_dispatch_valid() {
+  if constexpr (!all_values<castable_to<string_entry_function<Entries>, T>...>) {
+    return false;
+  } else {
+    return string_dispatch_unique<Entries...>();
+  }
+}
+
+template <function_type T, function auto F, type_list>
+struct string_dispatch_entry_f;
+template <function_type T, function auto F, typename... Args>
+struct string_dispatch_entry_f<T, F, list<Args...>> {
+  inline static constexpr decltype(auto)
+  f(std::string_view, Args... args) noexcept(noexcept(cast<T, F>(maybe_move<Args>(args)...))) {
+    return cast<T, F>(maybe_move<Args>(args)...);
+  }
+};
+
+template <typename R, type_list>
+struct string_dispatch_unknown;
+template <typename R, typename... Args>
+struct string_dispatch_unknown<R, list<Args...>> {
+  [[noreturn]] inline static R f(std::string_view, Args...) {
+    throw std::out_of_range{"sfn::string_dispatch: unknown key"};
+  }
+};
+
+// Default is nullptr if there is no default handler, in which case an unknown key throws
+// std::out_of_range.
+template <typename R, type_list Args, auto Default, string_entry... Entries>
+struct string_dispatch_impl {
+  using entry_type = typename string_dispatch_function<R, Args>::entry_type;
+  using function_type = typename string_dispatch_function<R, Args>::type;
+
+  inline static constexpr auto unknown = [] {
+    if constexpr (std::is_null_pointer_v<decltype(Default)>) {
+      return &string_dispatch_unknown<R, Args>::f;
+    } else {
+      return cast<function_type, Default>;
+    }
+  }();
+  inline static constexpr std::string_view keys[] = {Entries::key...};
+  inline static constexpr ptr<function_type> handlers[] = {
+      &string_dispatch_entry_f<entry_type, Entries::value, Args>::f...};
+  inline static constexpr bool is_noexcept = all_values<
+      sfn::is_noexcept<decltype(unknown)>,
+      sfn::is_noexcept<decltype(&string_dispatch_entry_f<entry_type, Entries::value, Args>::f)>...>;
+
+  inline static constexpr auto table = make_string_dispatch_table(keys, handlers, unknown);
+};
+
+template <typename Impl, type_list>
+struct string_dispatch_f;
+template <typename Impl, typename... Args>
+struct string_dispatch_f<Impl, list<Args...>> {
+  // One hash, one comparison and one indirect call. The slot for an unknown key may hold another
+  // key, so it is always compared.
+  STATIC_FUNCTIONAL_FUSE inline static constexpr decltype(auto)
+  f(std::string_view key, Args... args) noexcept(Impl::is_noexcept) {
+    const auto& slot = Impl::table.find(key);
+    return (string_dispatch_equal(slot.key, key) ? slot.f : Impl::unknown)(
+        key, maybe_move<Args>(args)...);
+  }
+};
+
+template <typename R, type_list Args, auto Default, string_entry... Entries>
+inline constexpr auto string_dispatch_of =
+    &string_dispatch_f<string_dispatch_impl<R, Args, Default, Entries...>, Args>::f;
+
+template <string_entry Entry>
+using string_dispatch_entry_type = function_type_of<string_entry_function<Entry>>;
+
+// The default handler takes the key, followed by the arguments of every other handler.
+template <functional Default>
+using string_dispatch_default_args = drop_front<parameter_types_of<Default>>;
+template <functional Default>
+using string_dispatch_default_function =
+    string_dispatch_function<return_type_of<Default>, string_dispatch_default_args<Default>>;
+}  // namespace detail
+
+template <typename... Entries>
+concept string_dispatchable = sizeof...(Entries) != 0u && (string_entry<Entries> && ...) &&
+    detail::string_dispatch_valid<detail::string_dispatch_entry_type<front<list<Entries...>>>,
+                                  Entries...>();
+
+template <typename Default, typename... Entries>
+concept string_dispatchable_or = functional<Default> && sizeof...(Entries) != 0u &&
+    (string_entry<Entries> && ...) && (size<parameter_types_of<Default>> != 0u) &&
+    castable_to<Default, typename detail::string_dispatch_default_function<Default>::type> &&
+    detail::string_dispatch_valid<
+        typename detail::string_dispatch_default_function<Default>::entry_type, Entries...>();
+
+template <typename... Entries>
+requires string_dispatchable<Entries...>
+inline constexpr auto string_dispatch = detail::string_dispatch_of<
+    return_type_of<detail::string_dispatch_entry_type<front<list<Entries...>>>>,
+    parameter_types_of<detail::string_dispatch_entry_type<front<list<Entries...>>>>, nullptr,
+    Entries...>;
+
+template <function auto Default, typename... Entries>
+requires string_dispatchable_or<decltype(Default), Entries...>
+inline constexpr auto string_dispatch_or =
+    detail::string_dispatch_of<return_type_of<decltype(Default)>,
+                               detail::string_dispatch_default_args<decltype(Default)>, Default,
+                               Entries...>;
+
+}  // namespace sfn
+
+#endif
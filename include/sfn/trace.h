@@ -0,0 +1,248 @@
+#ifndef STATIC_FUNCTIONAL_INCLUDE_SFN_TRACE_H
+#define STATIC_FUNCTIONAL_INCLUDE_SFN_TRACE_H
+#include <sfn/functional.h>
+#include <sfn/type_list.h>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <new>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <x86intrin.h>
+#define STATIC_FUNCTIONAL_TRACE_TSC
+#endif
+
+// Number of events in each thread's trace buffer. Events are dropped while a buffer is full.
+#ifndef STATIC_FUNCTIONAL_TRACE_BUFFER_EVENTS
+#define STATIC_FUNCTIONAL_TRACE_BUFFER_EVENTS 65536
+#endif
+
+namespace sfn {
+//-------------------------------------------------------------------------------------------------
+// trace
+//-------------------------------------------------------------------------------------------------
+namespace detail {
+// Raw timestamp: the TSC where available, otherwise steady_clock nanoseconds.
+inline std::uint64_t trace_now() noexcept {
+#ifdef STATIC_FUNCTIONAL_TRACE_TSC
+  return __rdtsc();
+#else
+  return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                        std::chrono::steady_clock::now().time_since_epoch())
+                                        .count());
+#endif
+}
+
+inline std::uint64_t trace_steady_ns() noexcept {
+  return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                        std::chrono::steady_clock::now().time_since_epoch())
+                                        .count());
+}
+
+// One call: begin and end timestamps, exported as a Chrome "complete" event.
+struct trace_event {
+  const char* name;
+  std::uint64_t begin;
+  std::uint64_t end;
+};
+
+// Single-producer (the owning thread), single-consumer (the collector) ring buffer.
+struct trace_buffer {
+  static constexpr std::size_t capacity = STATIC_FUNCTIONAL_TRACE_BUFFER_EVENTS;
+
+  void push(const trace_event& event) noexcept {
+    auto h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) == capacity) {
+      dropped.fetch_add(1u, std::memory_order_relaxed);
+      return;
+    }
+    events[h % capacity] = event;
+    head.store(h + 1u, std::memory_order_release);
+  }
+
+  std::atomic<std::size_t> head = 0;
+  alignas(64) std::atomic<std::size_t> tail = 0;
+  std::atomic<std::uint64_t> dropped = 0;
+  // Cleared when the owning thread exits.
+  std::atomic<bool> in_use = true;
+  std::uint32_t tid = 0;
+  trace_buffer* next = nullptr;
+  trace_event events[capacity];
+};
+
+struct trace_state {
+  std::atomic<bool> enabled = false;
+  std::uint32_t next_tid = 1;
+  // Guards the list of buffers (but not their events) and collection.
+  std::mutex mutex;
+  trace_buffer* buffers = nullptr;
+  // Reference point for converting timestamps, set by the first trace_start().
+  std::atomic<std::uint64_t> base_ticks = 0;
+  std::atomic<std::uint64_t> base_ns = 0;
+};
+inline constinit trace_state trace_global;
+
+// Reuses the buffer of an exited thread whose events have all been collected if there is one, or
+// else adds a new one. This only happens on a thread's first traced call while tracing is enabled.
+inline trace_buffer* trace_register_buffer() noexcept {
+  std::lock_guard lock{trace_global.mutex};
+  trace_buffer* buffer = nullptr;
+  for (auto* b = trace_global.buffers; b && !buffer; b = b->next) {
+    if (!b->in_use.load(std::memory_order_acquire) &&
+        b->tail.load(std::memory_order_relaxed) == b->head.load(std::memory_order_relaxed)) {
+      buffer = b;
+      buffer->in_use.store(true, std::memory_order_relaxed);
+    }
+  }
+  if (!buffer && (buffer = new (std::nothrow) trace_buffer)) {
+    buffer->next = trace_global.buffers;
+    trace_global.buffers = buffer;
+  }
+  if (buffer) {
+    buffer->tid = trace_global.next_tid++;
+  }
+  return buffer;
+}
+
+inline constinit thread_local trace_buffer* trace_local = nullptr;
+
+// An exited thread's buffer is kept until its events have been collected: trace_collect frees it
+// then, unless a new thread has reused it first.
+struct trace_buffer_release {
+  ~trace_buffer_release() {
+    if (trace_local) {
+      trace_local->in_use.store(false, std::memory_order_release);
+      trace_local = nullptr;
+    }
+  }
+};
+
+inline trace_buffer* trace_local_buffer() noexcept {
+  if (!trace_local) [[unlikely]] {
+    trace_local = trace_register_buffer();
+    thread_local trace_buffer_release release;
+  }
+  return trace_local;
+}
+
+inline void trace_escape(std::string& out, std::string_view s) {
+  for (char c : s) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+      out += c;
+    } else if (static_cast<unsigned char>(c) < 0x20u) {
+      char escaped[8];
+      std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+      out += escaped;
+    } else {
+      out += c;
+    }
+  }
+}
+
+template <function auto F, string_literal Name, type_list>
+struct trace_f;
+template <function auto F, string_literal Name, typename... Args>
+struct trace_f<F, Name, list<Args...>> {
+  struct scope {
+    std::uint64_t begin = trace_now();
+    ~scope() {
+      auto end = trace_now();
+      if (auto* buffer = trace_local_buffer()) {
+        buffer->push({Name.value, begin, end});
+      }
+    }
+  };
+
+  inline static decltype(auto) f(Args... args) noexcept(noexcept(F(maybe_move<Args>(args)...))) {
+    if (!trace_global.enabled.load(std::memory_order_relaxed)) {
+      return F(maybe_move<Args>(args)...);
+    }
+    scope s;
+    return F(maybe_move<Args>(args)...);
+  }
+};
+}  // namespace detail
+
+template <function auto F, string_literal Name>
+inline constexpr auto trace =
+    &detail::trace_f<unwrap<F>, Name, parameter_types_of<decltype(F)>>::f;
+
+// Starts or stops recording events from all sfn::trace functions.
+inline void trace_start() noexcept {
+  std::uint64_t zero = 0;
+  if (detail::trace_global.base_ticks.compare_exchange_strong(zero, detail::trace_now())) {
+    detail::trace_global.base_ns.store(detail::trace_steady_ns());
+  }
+  detail::trace_global.enabled.store(true, std::memory_order_relaxed);
+}
+
+inline void trace_stop() noexcept {
+  detail::trace_global.enabled.store(false, std::memory_order_relaxed);
+}
+
+// Removes all recorded events from the per-thread buffers and returns them as a JSON trace in the
+// Chrome trace event format, which can be loaded into chrome://tracing or Perfetto.
+inline std::string trace_collect() {
+  auto& global = detail::trace_global;
+  std::lock_guard lock{global.mutex};
+
+  auto base_ticks = global.base_ticks.load();
+  auto base_ns = global.base_ns.load();
+  double ticks_per_us = 1000.;
+#ifdef STATIC_FUNCTIONAL_TRACE_TSC
+  auto elapsed_ns = detail::trace_steady_ns() - base_ns;
+  auto elapsed_ticks = detail::trace_now() - base_ticks;
+  if (base_ticks && elapsed_ns) {
+    ticks_per_us = 1000. * static_cast<double>(elapsed_ticks) / static_cast<double>(elapsed_ns);
+  }
+#else
+  (void)base_ns;
+#endif
+
+  std::string out = "{\"traceEvents\":[";
+  std::uint64_t dropped = 0;
+  bool first = true;
+  char number[64];
+  for (auto** link = &global.buffers; auto* buffer = *link;) {
+    // Read before draining, so that an exited thread has pushed all of its events.
+    bool exited = !buffer->in_use.load(std::memory_order_acquire);
+    auto tail = buffer->tail.load(std::memory_order_relaxed);
+    auto head = buffer->head.load(std::memory_order_acquire);
+    for (; tail != head; ++tail) {
+      const auto& event = buffer->events[tail % detail::trace_buffer::capacity];
+      auto ts = static_cast<double>(static_cast<std::int64_t>(event.begin - base_ticks)) /
+          ticks_per_us;
+      auto dur = static_cast<double>(event.end - event.begin) / ticks_per_us;
+      out += first ? "{\"name\":\"" : ",{\"name\":\"";
+      first = false;
+      detail::trace_escape(out, event.name);
+      std::snprintf(number, sizeof(number), "\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f", ts, dur);
+      out += number;
+      std::snprintf(number, sizeof(number), ",\"pid\":1,\"tid\":%u}", buffer->tid);
+      out += number;
+    }
+    buffer->tail.store(tail, std::memory_order_release);
+    dropped += buffer->dropped.exchange(0u, std::memory_order_relaxed);
+    if (exited) {
+      *link = buffer->next;
+      delete buffer;
+    } else {
+      link = &buffer->next;
+    }
+  }
+  std::snprintf(number, sizeof(number), "],\"otherData\":{\"dropped_events\":%llu}}",
+                static_cast<unsigned long long>(dropped));
+  out += number;
+  return out;
+}
+
+}  // namespace sfn
+
+#endif
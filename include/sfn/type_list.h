@@ -1,8 +1,10 @@
 #ifndef STATIC_FUNCTIONAL_INCLUDE_SFN_TYPE_LIST_H
 #define STATIC_FUNCTIONAL_INCLUDE_SFN_TYPE_LIST_H
+#include <array>
 #include <cstddef>
 #include <limits>
 #include <type_traits>
+#include <utility>
 
 namespace sfn {
 
@@ -53,108 +55,229 @@ template <type_list A, template <typename...> typename Template>
 using to = decltype(detail::to_impl<Template>(A{}));
 
 namespace detail {
-template <type_list A>
-constexpr auto drop_back_impl(A) {
-  if constexpr (size<A> == 1) {
-    return list<>{};
-  } else {
-    return prepend<front<A>, decltype(drop_back_impl(drop_front<A>{}))>{};
-  }
-}
+#if defined(__has_builtin)
+#if __has_builtin(__type_pack_element)
+#define STATIC_FUNCTIONAL_HAS_TYPE_PACK_ELEMENT
+#endif
+#endif
+
+template <std::size_t, typename T>
+using ignore_index = T;
+template <typename>
+struct drop_front_n;
+template <std::size_t... Ns>
+struct drop_front_n<std::index_sequence<Ns...>> {
+  template <typename... Ts>
+  static auto f(ignore_index<Ns, const void*>..., list<Ts>*...) -> list<Ts...>;
+};
+template <std::size_t N, typename... Ts>
+constexpr auto drop_front_n_impl(list<Ts...>)
+    -> decltype(drop_front_n<std::make_index_sequence<N>>::f(static_cast<list<Ts>*>(nullptr)...));
+
+#ifdef STATIC_FUNCTIONAL_HAS_TYPE_PACK_ELEMENT
+template <std::size_t N, typename... Ts>
+constexpr auto get_impl(list<Ts...>) -> list<__type_pack_element<N, Ts...>>;
 
 template <std::size_t N, type_list A>
-constexpr auto get_impl(A) {
-  if constexpr (N == 0) {
-    return list<front<A>>{};
-  } else {
-    return get_impl<N - 1>(drop_front<A>{});
-  }
-}
+using get_t = front<decltype(get_impl<N>(A{}))>;
 
-template <std::size_t Index, std::size_t Size, type_list A>
+template <type_list A, std::size_t... Ns>
+constexpr auto take_impl(A, std::index_sequence<Ns...>) -> list<get_t<Ns, A>...>;
+template <std::size_t Size, type_list A>
+using take_t = decltype(take_impl(A{}, std::make_index_sequence<Size>{}));
+#else
+// Lookup cost is linear in the length of the list, but instantiation depth is constant.
+template <std::size_t N, type_list A>
+using get_t = front<decltype(drop_front_n_impl<N>(A{}))>;
+
+// Bulk operations can't afford a linear lookup per element, so instead they map each element to
+// list<T> (to keep it) or list<> (to drop it), and join the results with a single fold. The fold
+// collects up to 32 kept elements at a time, and merges each full chunk into a stack of lists of
+// doubling sizes, so every element is copied a logarithmic number of times. The stack is a
+// non-type template argument, since argument-dependent lookup for each step of the fold would
+// otherwise visit every element collected so far.
+inline constexpr std::size_t compact_chunk_size = 32;
+
+template <typename A, typename B>
+struct compact_concat;
+template <typename... As, typename... Bs>
+struct compact_concat<list<As...>, list<Bs...>> {
+  using type = list<As..., Bs...>;
+};
+
+template <std::size_t Rank, type_list A>
+struct compact_node {};
+template <typename... Nodes>
+struct compact_stack {};
+
+template <typename Stack, typename Node>
+struct compact_push;
+template <typename... Nodes, typename Node>
+struct compact_push<compact_stack<Nodes...>, Node> {
+  using type = compact_stack<Node, Nodes...>;
+};
+template <std::size_t Rank, type_list A, type_list B, typename... Nodes>
+struct compact_push<compact_stack<compact_node<Rank, A>, Nodes...>, compact_node<Rank, B>>
+    : compact_push<compact_stack<Nodes...>,
+                   compact_node<Rank + 1u, typename compact_concat<A, B>::type>> {};
+
+template <typename Stack>
+struct compact_flatten {
+  using type = list<>;
+};
+template <std::size_t Rank, type_list A, typename... Nodes>
+struct compact_flatten<compact_stack<compact_node<Rank, A>, Nodes...>>
+    : compact_concat<typename compact_flatten<compact_stack<Nodes...>>::type, A> {};
+
+template <auto Stack, typename... Ts>
+struct compact_state {};
+template <typename Stack, typename... Ts>
+using compact_state_t = compact_state<static_cast<Stack*>(nullptr), Ts...>;
+template <auto Stack>
+using compact_stack_t = std::remove_pointer_t<decltype(Stack)>;
+
+template <auto Stack, typename... Ts>
+constexpr auto operator+(compact_state<Stack, Ts...>, list<>) -> compact_state<Stack, Ts...>;
+template <auto Stack, typename... Ts, typename T>
+requires(sizeof...(Ts) + 1u < compact_chunk_size) constexpr auto
+operator+(compact_state<Stack, Ts...>, list<T>) -> compact_state<Stack, Ts..., T>;
+template <auto Stack, typename... Ts, typename T>
+requires(sizeof...(Ts) + 1u == compact_chunk_size) constexpr auto
+operator+(compact_state<Stack, Ts...>, list<T>) -> compact_state_t<
+    typename compact_push<compact_stack_t<Stack>, compact_node<0, list<Ts..., T>>>::type>;
+
+template <auto Stack, typename... Ts>
+constexpr auto compact_result(compact_state<Stack, Ts...>) ->
+    typename compact_concat<typename compact_flatten<compact_stack_t<Stack>>::type,
+                            list<Ts...>>::type;
+
+template <typename... Ls>
+using compact = decltype(compact_result((compact_state_t<compact_stack<>>{} + ... + Ls{})));
+
+template <std::size_t Size, typename... Ts, std::size_t... Ns>
+constexpr auto take_impl(list<Ts...>, std::index_sequence<Ns...>)
+    -> compact<std::conditional_t<(Ns < Size), list<Ts>, list<>>...>;
+template <std::size_t Size, type_list A>
+using take_t = decltype(take_impl<Size>(A{}, std::make_index_sequence<size<A>>{}));
+#endif
+
+template <std::size_t Size, type_list A>
 constexpr auto sublist_impl(A) {
-  if constexpr (empty<A> || Size == 0) {
-    return list<>{};
-  } else if constexpr (Index == 0) {
-    return prepend<front<A>, decltype(sublist_impl<0, Size - 1>(drop_front<A>{}))>{};
+  if constexpr (Size < size<A>) {
+    return take_t<Size, A>{};
   } else {
-    return sublist_impl<Index - 1, Size>(drop_front<A>{});
+    return A{};
   }
 }
 
+template <std::size_t Index, std::size_t Size, type_list A>
+using sublist_t = decltype(sublist_impl<Size>(decltype(drop_front_n_impl<Index>(A{})){}));
+
 template <template <typename...> typename F, typename... Ts>
-constexpr auto apply_impl() {
-  if constexpr (requires { typename F<Ts...>::type; }) {
-    return list<typename F<Ts...>::type>{};
-  } else {
-    return list<F<Ts...>>{};
-  }
-}
+struct apply_impl {
+  using type = F<Ts...>;
+};
+template <template <typename...> typename F, typename... Ts>
+requires requires { typename F<Ts...>::type; }
+struct apply_impl<F, Ts...> {
+  using type = typename F<Ts...>::type;
+};
 }  // namespace detail
 
 template <type_list A, std::size_t Index>
-requires(Index < size<A>) using get = front<decltype(detail::get_impl<Index>(A{}))>;
+requires(Index < size<A>) using get = detail::get_t<Index, A>;
 template <type_list A>
 requires(!empty<A>) using back = get<A, size<A> - 1u>;
 template <type_list A>
-requires(!empty<A>) using drop_back = decltype(detail::drop_back_impl(A{}));
+requires(!empty<A>) using drop_back = detail::sublist_t<0, size<A> - 1u, A>;
 template <type_list A, std::size_t Index, std::size_t Size = npos>
-requires(Index <= size<A>) using sublist = decltype(detail::sublist_impl<Index, Size>(A{}));
+requires(Index <= size<A>) using sublist = detail::sublist_t<Index, Size, A>;
 template <type_list A, std::size_t Index, std::size_t Size = npos>
 requires(Index <= size<A>) using erase = concat<
     sublist<A, 0, Index>, sublist<A, Index + (Size <= size<A> - Index ? Size : size<A> - Index)>>;
 template <type_list A, std::size_t... Indices>
 requires((Indices < size<A>)&&...) using select = list<get<A, Indices>...>;
 template <template <typename...> typename F, typename... Ts>
-using apply = front<decltype(detail::apply_impl<F, Ts...>())>;
+using apply = typename detail::apply_impl<F, Ts...>::type;
 
 namespace detail {
 template <template <typename...> typename P, typename... Ts>
 constexpr bool all_of_impl(list<Ts...>) {
-  return (P<Ts>::value && ...);
+  constexpr bool values[] = {P<Ts>::value..., true};
+  for (bool value : values) {
+    if (!value) {
+      return false;
+    }
+  }
+  return true;
 }
 
 template <template <typename...> typename P, typename... Ts>
 constexpr bool any_of_impl(list<Ts...>) {
-  return (P<Ts>::value || ...);
+  constexpr bool values[] = {P<Ts>::value..., false};
+  for (bool value : values) {
+    if (value) {
+      return true;
+    }
+  }
+  return false;
 }
 
-template <template <typename...> typename P, type_list A>
-constexpr std::size_t find_if_impl(A) {
-  if constexpr (empty<A>) {
-    return 0;
-  } else if constexpr (P<front<A>>::value) {
-    return 0;
-  } else {
-    return 1 + find_if_impl<P>(drop_front<A>{});
+template <template <typename...> typename P, typename... Ts>
+constexpr std::size_t find_if_impl(list<Ts...>) {
+  constexpr bool values[] = {P<Ts>::value..., false};
+  std::size_t i = 0;
+  while (i < sizeof...(Ts) && !values[i]) {
+    ++i;
   }
+  return i;
 }
 
 template <template <typename...> typename P, typename... Ts>
 constexpr std::size_t count_if_impl(list<Ts...>) {
-  return ((P<Ts>::value ? 1u : 0u) + ... + 0u);
-}
-
-template <template <typename...> typename P, type_list A>
-constexpr auto filter_impl(A) {
-  if constexpr (empty<A>) {
-    return list<>{};
-  } else if constexpr (P<front<A>>::value) {
-    return prepend<front<A>, decltype(filter_impl<P>(drop_front<A>{}))>{};
-  } else {
-    return filter_impl<P>(drop_front<A>{});
+  constexpr bool values[] = {P<Ts>::value..., false};
+  std::size_t count = 0;
+  for (bool value : values) {
+    count += value ? 1u : 0u;
   }
+  return count;
 }
 
-template <template <typename...> typename F, type_list A>
-constexpr auto map_impl(A) {
-  if constexpr (empty<A>) {
-    return list<>{};
-  } else {
-    return prepend<apply<F, front<A>>, decltype(map_impl<F>(drop_front<A>{}))>{};
+#ifdef STATIC_FUNCTIONAL_HAS_TYPE_PACK_ELEMENT
+template <template <typename...> typename P, typename... Ts>
+constexpr auto filter_indices_impl(list<Ts...>) {
+  constexpr bool values[] = {P<Ts>::value..., false};
+  std::array<std::size_t, count_if_impl<P>(list<Ts...>{})> indices{};
+  for (std::size_t i = 0, j = 0; i < sizeof...(Ts); ++i) {
+    if (values[i]) {
+      indices[j++] = i;
+    }
   }
+  return indices;
 }
 
+template <template <typename...> typename P, type_list A>
+inline constexpr auto filter_indices = filter_indices_impl<P>(A{});
+
+template <template <typename...> typename P, type_list A, std::size_t... Ns>
+constexpr auto filter_impl(A, std::index_sequence<Ns...>)
+    -> list<get_t<filter_indices<P, A>[Ns], A>...>;
+
+template <template <typename...> typename P, type_list A>
+using filter_t =
+    decltype(filter_impl<P>(A{}, std::make_index_sequence<filter_indices<P, A>.size()>{}));
+#else
+template <template <typename...> typename P, typename... Ts>
+constexpr auto filter_impl(list<Ts...>)
+    -> compact<std::conditional_t<P<Ts>::value, list<Ts>, list<>>...>;
+
+template <template <typename...> typename P, type_list A>
+using filter_t = decltype(filter_impl<P>(A{}));
+#endif
+
+template <template <typename...> typename F, typename... Ts>
+constexpr auto map_impl(list<Ts...>) -> list<apply<F, Ts>...>;
+
 template <typename T>
 struct same_as_metafunction {
   template <typename U>
@@ -189,7 +312,7 @@ inline constexpr std::size_t count =
     count_if<A, detail::same_as_metafunction<T>::template predicate>;
 
 template <type_list A, template <typename...> typename P>
-using filter = decltype(detail::filter_impl<P>(A{}));
+using filter = detail::filter_t<P, A>;
 template <type_list A, template <typename...> typename F>
 using map = decltype(detail::map_impl<F>(A{}));
 template <type_list A, template <typename...> typename P>
@@ -0,0 +1,177 @@
+#ifndef STATIC_FUNCTIONAL_INCLUDE_SFN_VISIT_TABLE_H
+#define STATIC_FUNCTIONAL_INCLUDE_SFN_VISIT_TABLE_H
+#include <sfn/functional.h>
+#include <sfn/type_list.h>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace sfn {
+//-------------------------------------------------------------------------------------------------
+// visit_table / visit_table_or
+//-------------------------------------------------------------------------------------------------
+namespace detail {
+template <typename T>
+struct variant_alternatives_impl {};
+template <typename... Ts>
+struct variant_alternatives_impl<std::variant<Ts...>> {
+  using type = list<Ts...>;
+};
+}  // namespace detail
+
+template <typename T>
+concept variant = requires {
+  typename detail::variant_alternatives_impl<std::remove_cv_t<T>>::type;
+};
+
+template <variant T>
+using variant_alternatives = typename detail::variant_alternatives_impl<std::remove_cv_t<T>>::type;
+
+namespace detail {
+// Every function in the table has type R(First, Args...), where Args are the parameters of the
+// handler (or default) after the first.
+template <typename R, typename First, type_list Args>
+struct visit_function;
+template <typename R, typename First, typename... Args>
+struct visit_function<R, First, list<Args...>> {
+  using type = R(First, Args...);
+};
+
+// The alternative handled by a handler is the type of its first parameter.
+template <typename F>
+using visit_handled = std::remove_cvref_t<front<parameter_types_of<F>>>;
+
+template <typename Variant, typename T>
+using visit_alternative_ref =
+    std::conditional_t<std::is_const_v<Variant>, const T&, std::remove_cv_t<T>&>;
+
+template <typename Variant, typename R, type_list Args, typename... F>
+struct visit_table_check {
+  using alternatives = variant_alternatives<Variant>;
+  using handled = list<visit_handled<F>...>;
+
+  template <typename T>
+  using is_alternative = std::bool_constant<count<alternatives, T> == 1u>;
+  template <typename T>
+  using is_handled = std::bool_constant<find<handled, T> != size<handled>>;
+  template <typename T>
+  using handler_parameter = visit_alternative_ref<Variant, visit_handled<T>>;
+
+  // Each handler matches exactly one alternative, which no other handler matches, and can be cast
+  // to the type of the table entry for that alternative.
+  inline static constexpr bool valid = all_of<handled, is_alternative> &&
+      ((count<handled, visit_handled<F>> == 1u) && ...) &&
+      (castable_to<F, typename visit_function<R, handler_parameter<F>, Args>::type> && ...);
+  inline static constexpr bool exhaustive = all_of<alternatives, is_handled>;
+};
+
+template <typename Variant, std::size_t I, function auto H, typename R, type_list>
+struct visit_table_entry;
+template <typename Variant, std::size_t I, function auto H, typename R, typename... Args>
+struct visit_table_entry<Variant, I, H, R, list<Args...>> {
+  // The index has already been checked, so there's no need for std::get.
+  using alternative = visit_alternative_ref<Variant, std::variant_alternative_t<I, Variant>>;
+  inline static constexpr R f(Variant& v, Args... args) noexcept(noexcept(
+      cast<R(alternative, Args...), H>(*std::get_if<I>(&v), maybe_move<Args>(args)...))) {
+    return cast<R(alternative, Args...), H>(*std::get_if<I>(&v), maybe_move<Args>(args)...);
+  }
+};
+
+template <typename Variant, typename R, type_list>
+struct visit_table_valueless;
+template <typename Variant, typename R, typename... Args>
+struct visit_table_valueless<Variant, R, list<Args...>> {
+  [[noreturn]] inline static R f(Variant&, Args...) {
+    throw std::bad_variant_access{};
+  }
+};
+
+// Default is nullptr if there is no default handler, in which case a valueless variant throws
+// std::bad_variant_access as with std::visit.
+template <typename Variant, typename R, type_list Args, auto Default, function auto... F>
+struct visit_table_impl {
+  using alternatives = variant_alternatives<Variant>;
+  using handled = list<visit_handled<decltype(F)>...>;
+  using handlers = indexed_values<std::index_sequence_for<decltype(F)...>, F...>;
+  using function_type = typename visit_function<R, Variant&, Args>::type;
+
+  template <std::size_t I>
+  inline static constexpr auto entry = [] {
+    constexpr auto index = find<handled, get<alternatives, I>>;
+    if constexpr (index != size<handled>) {
+      constexpr auto h = get_indexed_value<index>(static_cast<const handlers*>(nullptr));
+      return &visit_table_entry<Variant, I, h, R, Args>::f;
+    } else {
+      return cast<function_type, Default>;
+    }
+  }();
+  inline static constexpr auto valueless = [] {
+    if constexpr (std::is_null_pointer_v<decltype(Default)>) {
+      return &visit_table_valueless<Variant, R, Args>::f;
+    } else {
+      return cast<function_type, Default>;
+    }
+  }();
+
+  // Entry 0 is for a valueless variant, whose index() is variant_npos, so that index() + 1 is
+  // always in range.
+  template <typename = std::make_index_sequence<size<alternatives>>>
+  struct table;
+  template <std::size_t... Is>
+  struct table<std::index_sequence<Is...>> {
+    inline static constexpr ptr<function_type> entries[] = {valueless, entry<Is>...};
+    inline static constexpr bool is_noexcept =
+        sfn::is_noexcept<decltype(valueless)> && (sfn::is_noexcept<decltype(entry<Is>)> && ...);
+  };
+};
+
+template <typename Impl, type_list>
+struct visit_table_f;
+template <typename Impl, typename Variant, typename... Args>
+struct visit_table_f<Impl, list<Variant, Args...>> {
+  using table = typename Impl::template table<>;
+  STATIC_FUNCTIONAL_FUSE inline static constexpr decltype(auto)
+  f(Variant v, Args... args) noexcept(table::is_noexcept) {
+    return table::entries[v.index() + 1u](v, maybe_move<Args>(args)...);
+  }
+};
+
+template <typename Variant, typename R, type_list Args, auto Default, function auto... F>
+inline constexpr auto visit_table_of =
+    &visit_table_f<visit_table_impl<Variant, R, Args, Default, F...>,
+                   parameter_types_of<typename visit_function<R, Variant&, Args>::type>>::f;
+}  // namespace detail
+
+template <typename Variant, typename F, typename... Rest>
+concept visitable = variant<Variant> && functional<F> && (functional<Rest> && ...) &&
+    (size<parameter_types_of<F>> != 0u) && ((size<parameter_types_of<Rest>> != 0u) && ...) &&
+    detail::visit_table_check<Variant, return_type_of<F>, drop_front<parameter_types_of<F>>, F,
+                              Rest...>::valid &&
+    detail::visit_table_check<Variant, return_type_of<F>, drop_front<parameter_types_of<F>>, F,
+                              Rest...>::exhaustive;
+
+template <typename Variant, typename Default, typename... F>
+concept visitable_or = variant<Variant> && functional<Default> && (functional<F> && ...) &&
+    (size<parameter_types_of<Default>> != 0u) && ((size<parameter_types_of<F>> != 0u) && ...) &&
+    castable_to<Default,
+                typename detail::visit_function<return_type_of<Default>, Variant&,
+                                                drop_front<parameter_types_of<Default>>>::type> &&
+    detail::visit_table_check<Variant, return_type_of<Default>,
+                              drop_front<parameter_types_of<Default>>, F...>::valid;
+
+template <typename Variant, function auto F, function auto... Rest>
+requires visitable<Variant, decltype(F), decltype(Rest)...>
+inline constexpr auto visit_table =
+    detail::visit_table_of<Variant, return_type_of<decltype(F)>,
+                           drop_front<parameter_types_of<decltype(F)>>, nullptr, F, Rest...>;
+
+template <typename Variant, function auto Default, function auto... F>
+requires visitable_or<Variant, decltype(Default), decltype(F)...>
+inline constexpr auto visit_table_or =
+    detail::visit_table_of<Variant, return_type_of<decltype(Default)>,
+                           drop_front<parameter_types_of<decltype(Default)>>, Default, F...>;
+
+}  // namespace sfn
+
+#endif
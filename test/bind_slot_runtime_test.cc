@@ -0,0 +1,105 @@
+#include "test/check.h"
+#include <sfn/bind_slot.h>
+#include <cstddef>
+#include <thread>
+
+namespace sfn {
+namespace {
+
+struct Shard {
+  int id = 0;
+};
+struct BufferSize {
+  using type = std::size_t;
+};
+struct Scale {
+  using type = int;
+};
+struct Unset {
+  using type = long;
+};
+struct CurrentShard {
+  using type = Shard*;
+  static constexpr bool thread_local_slot = true;
+};
+struct Published {
+  using type = const int*;
+};
+
+std::size_t size_times(std::size_t size, int scale, int x) {
+  return size * static_cast<std::size_t>(scale) + static_cast<std::size_t>(x);
+}
+long unset_value(long value) {
+  return value;
+}
+int shard_id(Shard* shard) {
+  return shard ? shard->id : -1;
+}
+int read_published(const int* value) {
+  return value ? *value : -1;
+}
+
+void test_default_value() {
+  SFN_CHECK(bind_slot_load<Unset>() == 0);
+  SFN_CHECK((bind_slot<&unset_value, Unset>() == 0));
+  SFN_CHECK(bind_slot_load<CurrentShard>() == nullptr);
+}
+
+void test_store_rebinds() {
+  // Obtained before the slots are set; every call reads their current values.
+  auto* front = bind_slot_front<&size_times, BufferSize, Scale>;
+  auto* back = bind_slot_back<&size_times, Scale>;
+  SFN_CHECK(front(7) == 7u);
+  bind_slot_store<BufferSize>(10u);
+  bind_slot_store<Scale>(3);
+  SFN_CHECK(bind_slot_load<BufferSize>() == 10u);
+  SFN_CHECK(front(7) == 37u);
+  SFN_CHECK(back(2u, 5) == 13u);
+  bind_slot_store<Scale>(4);
+  SFN_CHECK(front(7) == 47u);
+  SFN_CHECK(back(2u, 5) == 14u);
+}
+
+void test_thread_local() {
+  auto* id = bind_slot<&shard_id, CurrentShard>;
+  Shard main_shard{1};
+  bind_slot_store<CurrentShard>(&main_shard);
+  SFN_CHECK(id() == 1);
+  std::thread other([id] {
+    // Each thread starts out with its own value-initialized slot.
+    SFN_CHECK(id() == -1);
+    Shard other_shard{2};
+    bind_slot_store<CurrentShard>(&other_shard);
+    SFN_CHECK(id() == 2);
+    bind_slot_store<CurrentShard>(nullptr);
+  });
+  other.join();
+  SFN_CHECK(id() == 1);
+  bind_slot_store<CurrentShard>(nullptr);
+}
+
+void test_publication() {
+  // The reader sees the value behind the pointer as written before the pointer was stored.
+  static int value = 0;
+  std::thread reader([] {
+    int seen = -1;
+    while (seen == -1) {
+      seen = bind_slot<&read_published, Published>();
+    }
+    SFN_CHECK(seen == 42);
+  });
+  value = 42;
+  bind_slot_store<Published>(&value);
+  reader.join();
+}
+
+}  // namespace
+}  // namespace sfn
+
+int main() {
+  sfn::test_default_value();
+  sfn::test_store_rebinds();
+  sfn::test_thread_local();
+  sfn::test_publication();
+  return 0;
+}
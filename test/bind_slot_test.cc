@@ -0,0 +1,81 @@
+#include <sfn/bind_slot.h>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace sfn {
+namespace {
+
+template <typename T, typename U>
+inline constexpr bool equal = std::is_same_v<T, U>;
+
+struct Shard {};
+struct BufferSize {
+  using type = std::size_t;
+};
+struct CurrentShard {
+  using type = Shard*;
+  static constexpr bool thread_local_slot = true;
+};
+struct OtherBufferSize {
+  using type = std::size_t;
+};
+struct Name {
+  using type = const char*;
+};
+struct NoType {};
+struct NotTriviallyCopyable {
+  using type = std::string;
+};
+struct TooLarge {
+  struct type {
+    char data[64];
+  };
+};
+
+struct A {
+  int f(std::size_t) const {
+    return 0;
+  }
+};
+
+int f(std::size_t, Shard*, int) {
+  return 0;
+}
+int g(std::string_view, long) noexcept {
+  return 0;
+}
+int h(Shard&) {
+  return 0;
+}
+
+static_assert(bind_slot_tag<BufferSize>);
+static_assert(bind_slot_tag<CurrentShard>);
+static_assert(!bind_slot_tag<NoType>);
+static_assert(!bind_slot_tag<NotTriviallyCopyable>);
+static_assert(!bind_slot_tag<TooLarge>);
+static_assert(!detail::bind_slot_thread_local<BufferSize>());
+static_assert(detail::bind_slot_thread_local<CurrentShard>());
+
+static_assert(bind_slot_bindable_front<decltype(&f), BufferSize>);
+static_assert(bind_slot_bindable_front<decltype(&f), BufferSize, CurrentShard>);
+static_assert(bind_slot_bindable_front<decltype(&g), Name>);
+static_assert(bind_slot_bindable_back<decltype(&g), BufferSize>);
+static_assert(bind_slot_bindable_back<decltype(&f), CurrentShard, BufferSize>);
+static_assert(!bind_slot_bindable_front<decltype(&f), CurrentShard>);
+static_assert(!bind_slot_bindable_back<decltype(&f), Name>);
+static_assert(!bind_slot_bindable_front<decltype(&h), CurrentShard>);
+static_assert(!bind_slot_bindable_front<decltype(&f), NoType>);
+
+static_assert(equal<decltype(bind_slot<&f, BufferSize>), int (*const)(Shard*, int)>);
+static_assert(equal<decltype(bind_slot_front<&f, BufferSize, CurrentShard>), int (*const)(int)>);
+static_assert(equal<decltype(bind_slot_back<&f, BufferSize>), int (*const)(std::size_t, Shard*)>);
+static_assert(equal<decltype(bind_slot_back<&g, BufferSize>),
+                    int (*const)(std::string_view) noexcept>);
+static_assert(equal<decltype(bind_slot_back<&A::f, BufferSize>), int (*const)(const A&)>);
+static_assert(bind_slot<&f, BufferSize> != bind_slot<&f, OtherBufferSize>);
+static_assert(equal<decltype(bind_slot_load<BufferSize>()), std::size_t>);
+
+}  // namespace
+}  // namespace sfn
@@ -0,0 +1,16 @@
+#ifndef STATIC_FUNCTIONAL_TEST_CHECK_H
+#define STATIC_FUNCTIONAL_TEST_CHECK_H
+#include <cstdio>
+#include <cstdlib>
+
+// Runtime tests have no framework: a failed check prints its location and aborts, so it's
+// reported by the test runner regardless of NDEBUG.
+#define SFN_CHECK(condition)                                                                  \
+  do {                                                                                        \
+    if (!(condition)) {                                                                       \
+      std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition);      \
+      std::abort();                                                                           \
+    }                                                                                         \
+  } while (false)
+
+#endif
@@ -0,0 +1,167 @@
+// Pairs of functions compared by codegen_test.py: each sfn_<name> calls an sfn-generated wrapper,
+// and the matching hand_<name> is the hand-written equivalent. With optimization enabled, the
+// bodies of each pair should compile to identical machine code.
+#include <sfn/functional.h>
+#include <memory>
+
+// Leaf functions are only declared, so both versions of each case must call them.
+int add_one(int);
+int sum(int, int);
+int subtract(int, int);
+void notify(int, int);
+struct Large {
+  long values[16];
+};
+Large make_large(int);
+long sum_large(Large);
+std::unique_ptr<int> make_unique_int(int);
+int consume_unique(std::unique_ptr<int>);
+struct Foo {
+  int f(int) const;
+  int take(int) &&;
+  int callback(int);
+};
+
+extern "C" {
+
+int sfn_unwrap(const Foo& foo, int x) {
+  return sfn::unwrap<&Foo::f>(foo, x);
+}
+int hand_unwrap(const Foo& foo, int x) {
+  return foo.f(x);
+}
+
+int sfn_unwrap_rvalue(Foo&& foo, int x) {
+  return sfn::unwrap<&Foo::take>(std::move(foo), x);
+}
+int hand_unwrap_rvalue(Foo&& foo, int x) {
+  return std::move(foo).take(x);
+}
+
+int sfn_sequence(int x, int y) {
+  return sfn::sequence<&notify, &sum>(x, y);
+}
+int hand_sequence(int x, int y) {
+  return notify(x, y), sum(x, y);
+}
+
+long sfn_cast(short x, int y) {
+  return sfn::cast<long(short, int), &add_one>(x, y);
+}
+long hand_cast(short x, int) {
+  return long(add_one(x));
+}
+
+int sfn_cast_default() {
+  return sfn::cast<int(), &sum>();
+}
+int hand_cast_default() {
+  return sum(0, 0);
+}
+
+int sfn_reinterpret(void* userdata, int x) {
+  return sfn::reinterpret<int(void*, int), &Foo::callback>(userdata, x);
+}
+int hand_reinterpret(void* userdata, int x) {
+  return reinterpret_cast<Foo*>(userdata)->callback(x);
+}
+
+int sfn_c_callback(void* userdata, int x) {
+  return sfn::c_callback<&Foo::callback>(userdata, x);
+}
+int hand_c_callback(void* userdata, int x) {
+  return static_cast<Foo*>(userdata)->callback(x);
+}
+
+int sfn_c_callback_back(int x, void* userdata) {
+  return sfn::c_callback_back<&Foo::f>(x, userdata);
+}
+int hand_c_callback_back(int x, void* userdata) {
+  return static_cast<const Foo*>(userdata)->f(x);
+}
+
+int sfn_c_callback_rvalue(void* userdata, int x) {
+  return sfn::c_callback<&Foo::take>(userdata, x);
+}
+int hand_c_callback_rvalue(void* userdata, int x) {
+  return std::move(*static_cast<Foo*>(userdata)).take(x);
+}
+
+int sfn_bind_front(int x) {
+  return sfn::bind_front<&subtract, 3>(x);
+}
+int hand_bind_front(int x) {
+  return subtract(3, x);
+}
+
+int sfn_bind_back(int x) {
+  return sfn::bind_back<&subtract, 3>(x);
+}
+int hand_bind_back(int x) {
+  return subtract(x, 3);
+}
+
+int sfn_compose(int x) {
+  return sfn::compose<&add_one, &add_one>(x);
+}
+int hand_compose(int x) {
+  return add_one(add_one(x));
+}
+
+int sfn_compose_front(int x, int y, int z) {
+  return sfn::compose_front<&subtract, &sum>(x, y, z);
+}
+int hand_compose_front(int x, int y, int z) {
+  return subtract(sum(x, y), z);
+}
+
+int sfn_compose_back(int x, int y, int z) {
+  return sfn::compose_back<&subtract, &sum>(x, y, z);
+}
+int hand_compose_back(int x, int y, int z) {
+  return subtract(x, sum(y, z));
+}
+
+long sfn_compose_large(int x) {
+  return sfn::compose<&sum_large, &make_large>(x);
+}
+long hand_compose_large(int x) {
+  return sum_large(make_large(x));
+}
+
+int sfn_compose_move_only(int x) {
+  return sfn::compose<&consume_unique, &make_unique_int>(x);
+}
+int hand_compose_move_only(int x) {
+  return consume_unique(make_unique_int(x));
+}
+
+int sfn_nested(int x) {
+  return sfn::compose<&add_one, sfn::bind_back<sfn::compose_front<&subtract, &add_one>, 3>>(x);
+}
+int hand_nested(int x) {
+  return add_one(subtract(add_one(x), 3));
+}
+
+int sfn_pipeline_front(int x, int y, int z) {
+  return sfn::pipeline_front<&add_one, &subtract, &sum>(x, y, z);
+}
+int hand_pipeline_front(int x, int y, int z) {
+  return sum(subtract(add_one(x), y), z);
+}
+
+int sfn_pipeline_back(int x, int y, int z) {
+  return sfn::pipeline_back<&add_one, &subtract, &sum>(x, y, z);
+}
+int hand_pipeline_back(int x, int y, int z) {
+  return sum(x, subtract(y, add_one(z)));
+}
+
+long sfn_pipeline_large(int x) {
+  return sfn::pipeline<&make_large, &sum_large>(x);
+}
+long hand_pipeline_large(int x) {
+  return sum_large(make_large(x));
+}
+
+}  // extern "C"
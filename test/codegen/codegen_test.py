@@ -0,0 +1,111 @@
+"""Checks that sfn wrappers compile to the same machine code as hand-written equivalents.
+
+Compiles codegen_cases.cc with optimization, disassembles it, and compares the body of every
+sfn_<name> function with that of hand_<name>. Fails if any pair differs, e.g. because the sfn
+version makes extra calls or touches the stack where the hand-written version does not.
+"""
+
+import argparse
+import difflib
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+FUNCTION = re.compile(r"^[0-9a-f]+ <([\w.]+)>:$")
+INSTRUCTION = re.compile(r"^\s*[0-9a-f]+:\s*(.*)$")
+RELOCATION = re.compile(r"^\s*[0-9a-f]+:\s*(R_\w+)\s+(\S+)$")
+STACK = re.compile(r"%[re]?sp\b|\bpush|\bpop|\bsp\b|\[sp")
+PADDING = re.compile(r"^(data16 )*(cs )?(nop\w*|xchg %ax,%ax|int3)\b")
+CALL = re.compile(r"^(callq?\b|jmpq? \*|jmpq?$|blr?\b)")
+
+
+def disassemble(args, directory, include_dir):
+    obj = os.path.join(directory, "codegen_cases.o")
+    source = os.path.join(os.path.dirname(os.path.abspath(__file__)), "codegen_cases.cc")
+    subprocess.run([args.cxx, "-std=c++20", "-O" + args.opt, "-fno-asynchronous-unwind-tables",
+                    "-I" + include_dir, "-c", source, "-o", obj] + args.copt, check=True)
+    output = subprocess.run([args.objdump, "-d", "-r", "--no-show-raw-insn", obj], check=True,
+                            capture_output=True, text=True).stdout
+    functions = {}
+    current = None
+    for line in output.splitlines():
+        match = FUNCTION.match(line)
+        if match:
+            current = functions.setdefault(match.group(1), [])
+            continue
+        if current is None:
+            continue
+        match = RELOCATION.match(line)
+        if match:
+            # The encoded operand of a relocated instruction is a placeholder.
+            if current:
+                current[-1] = re.sub(r" <(\.cold)?\+0x[0-9a-f]+>$", "", current[-1])
+            current.append("  reloc " + re.sub(r"[-+]0x[0-9a-f]+$", "", match.group(2)))
+            continue
+        match = INSTRUCTION.match(line)
+        if match:
+            current.append(normalize(match.group(1)))
+    # Alignment padding after a function is not part of its body.
+    for body in functions.values():
+        while body and PADDING.match(body[-1]):
+            body.pop()
+    return functions
+
+
+def normalize(instruction):
+    # Strip addresses and symbolic annotations that necessarily differ between the two versions,
+    # but keep the offsets of local branch targets.
+    instruction = re.sub(r"\s+", " ", instruction.split("#")[0]).strip()
+    instruction = re.sub(r"<(sfn|hand)_\w+(\.cold)?\+(0x[0-9a-f]+)>", r"<\2+\3>", instruction)
+    instruction = re.sub(r"<(sfn|hand)_\w+(\.cold)?>", r"<\2+0x0>", instruction)
+    instruction = re.sub(r"\b[0-9a-f]+ (<(\.cold)?\+0x[0-9a-f]+>)", r"\1", instruction)
+    return instruction
+
+
+def summarize(body):
+    calls = sum(1 for i in body if CALL.match(i))
+    stack = sum(1 for i in body if STACK.search(i))
+    return calls, stack
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--cxx", default=os.environ.get("CXX", "c++"))
+    parser.add_argument("--objdump", default="objdump")
+    parser.add_argument("--opt", default="2")
+    parser.add_argument("--copt", action="append", default=[])
+    args = parser.parse_args()
+
+    include_dir = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "..", "include")
+    with tempfile.TemporaryDirectory() as directory:
+        functions = disassemble(args, directory, include_dir)
+
+    names = sorted(name[4:] for name in functions if name.startswith("sfn_"))
+    if not names:
+        print("no sfn_ functions found in disassembly")
+        return 1
+    failures = 0
+    for name in names:
+        sfn = functions["sfn_" + name]
+        hand = functions.get("hand_" + name)
+        if hand is None:
+            print(f"FAIL {name}: no hand_{name}")
+            failures += 1
+            continue
+        if sfn == hand:
+            print(f"ok   {name}")
+            continue
+        failures += 1
+        (sfn_calls, sfn_stack), (hand_calls, hand_stack) = summarize(sfn), summarize(hand)
+        print(f"FAIL {name}: calls {sfn_calls} vs {hand_calls}, "
+              f"stack instructions {sfn_stack} vs {hand_stack}")
+        for line in difflib.unified_diff(hand, sfn, "hand_" + name, "sfn_" + name, lineterm=""):
+            print("  " + line)
+    print(f"{len(names) - failures}/{len(names)} cases match ({args.cxx} -O{args.opt})")
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -74,7 +74,7 @@ constexpr int accepts_move_only(MoveOnly) noexcept {
 constexpr MoveOnly make_move_only() noexcept {
   return {};
 }
-constexpr int c_callback(A*) {
+constexpr int c_mutable_callback(A*) {
   return 0;
 }
 constexpr int c_const_callback(const A*) {
@@ -95,6 +95,51 @@ constexpr int sum(int a, int b) {
 constexpr int minus(int a, int b) {
   return a - b;
 }
+template <typename T>
+struct SizeOfPlus {
+  static constexpr std::size_t f(std::size_t x) noexcept {
+    return sizeof(T) + x;
+  }
+};
+template <typename T>
+struct AlignOf {
+  static constexpr int f() {
+    return alignof(T);
+  }
+};
+template <typename T>
+struct TakesPointer {
+  static constexpr int f(T*) {
+    return 0;
+  }
+};
+template <typename T>
+struct NoHandler {};
+constexpr std::size_t unknown_type(std::size_t) noexcept {
+  return 0;
+}
+enum class Channels { kMono = 1, kStereo = 2, kSurround = 6 };
+constexpr int scale(Channels channels, int x) {
+  return static_cast<int>(channels) * x;
+}
+constexpr int square(int x) {
+  return x * x;
+}
+constexpr bool is_space(char c) noexcept {
+  return c == ' ' || c == '\t' || c == '\n';
+}
+// Counts how many times it has been moved since it was created.
+struct CountsMoves {
+  constexpr CountsMoves() = default;
+  constexpr CountsMoves(CountsMoves&& other) noexcept : moves{other.moves + 1} {}
+  int moves = 0;
+};
+constexpr int moves_of(CountsMoves c, int) {
+  return c.moves;
+}
+constexpr CountsMoves make_counts_moves() {
+  return {};
+}
 
 template <typename T, typename U>
 inline constexpr bool equal = std::is_same_v<T, U>;
@@ -271,7 +316,8 @@ static_assert(!reinterpretable_as<const void*(), A*()>);
 static_assert(!reinterpretable_as<int(A&), int(const void*)>);
 static_assert(!reinterpretable_as<const void*(), A&()>);
 static_assert(equal<function_type_of<decltype(reinterpret<int(), &f>)>, int()>);
-static_assert(equal<function_type_of<decltype(reinterpret<int(void*), &c_callback>)>, int(void*)>);
+static_assert(
+    equal<function_type_of<decltype(reinterpret<int(void*), &c_mutable_callback>)>, int(void*)>);
 static_assert(equal<function_type_of<decltype(reinterpret<int(const void*), &c_const_callback>)>,
                     int(const void*)>);
 static_assert(
@@ -281,6 +327,17 @@ static_assert(
           const void*(int)>);
 static_assert(reinterpret<int(), &f> == &f);
 
+static_assert(equal<function_type_of<decltype(c_callback<&A::c_callback>)>, int(void*, int)>);
+static_assert(equal<function_type_of<decltype(c_callback<&A::f>)>, int(void*)>);
+static_assert(equal<function_type_of<decltype(c_callback<&A::move_this>)>, int(void*)>);
+static_assert(equal<function_type_of<decltype(c_callback<&A::accepts_move_only>)>,
+                    int(void*, MoveOnly&&)>);
+static_assert(equal<function_type_of<decltype(c_callback_front<&A::g>)>, void(void*, int)>);
+static_assert(equal<function_type_of<decltype(c_callback_back<&A::g>)>, void(int, void*)>);
+static_assert(is_noexcept<decltype(c_callback<&A::no_except>)>);
+static_assert(is_noexcept<decltype(c_callback_back<&A::no_except>)>);
+static_assert(!is_noexcept<decltype(c_callback<&A::c_callback>)>);
+
 static_assert(bindable_front<void()>);
 static_assert(bindable_front<void(int)>);
 static_assert(bindable_front<void(int), int>);
@@ -354,17 +411,241 @@ static_assert(compose_front<&minus, &sum>(4, 3, 2) == 5);
 static_assert(compose_back<&minus, &sum>(4, 3, 2) == -1);
 static_assert(compose<&accepts_move_only, &make_move_only>() == 5);
 
+// With the fusion registry, nested wrappers pass arguments to the original function by reference,
+// so they're moved once; otherwise they're moved once per layer.
+static_assert(bind_back<&moves_of, 3>(CountsMoves{}) == 1);
+static_assert(compose<bind_back<&moves_of, 3>, &make_counts_moves>() == 1);
+static_assert(compose_back<&moves_of, compose<&int_identity, &A::f>>(CountsMoves{}, A{}) == 1);
+#ifndef STATIC_FUNCTIONAL_FUSION_REGISTRY
+static_assert(compose<&int_identity, bind_back<&moves_of, 3>>(CountsMoves{}) == 2);
+static_assert(compose<&int_identity, cast<long(CountsMoves), bind_back<&moves_of, 3>>>(
+                  CountsMoves{}) == 3);
+#else
+static_assert(detail::is_fused<bind_back<&moves_of, 3>>);
+static_assert(detail::is_fused<compose<&int_identity, &int_identity>>);
+static_assert(!detail::is_fused<&moves_of>);
+static_assert(compose<&int_identity, bind_back<&moves_of, 3>>(CountsMoves{}) == 1);
+static_assert(compose<&int_identity, cast<long(CountsMoves), bind_back<&moves_of, 3>>>(
+                  CountsMoves{}) == 1);
+static_assert(cast<int(CountsMoves, A), compose<&int_identity, bind_back<&moves_of, 3>>>(
+                  CountsMoves{}, A{}) == 1);
+#endif
+
+static_assert(pipeable<int()>);
+static_assert(pipeable<int(int), int(int), void(int)>);
+static_assert(pipeable<ConvertsToA(), int(A)>);
+static_assert(!pipeable<A(), int(ConvertsToA)>);
+static_assert(!pipeable<void(), int(int)>);
+static_assert(!pipeable<int(), int()>);
+static_assert(!pipeable<int(), int(int, A)>);
+static_assert(pipeable_front<int(), int(int, A), A(int, float)>);
+static_assert(!pipeable_front<A(), int(int, A)>);
+static_assert(pipeable_back<A(), int(int, A)>);
+static_assert(!pipeable_back<int(), int(int, A)>);
+static_assert(equal<function_type_of<decltype(pipeline<&f>)>, int()>);
+static_assert(equal<function_type_of<decltype(pipeline<&A::f, &int_identity, &g>)>,
+                    void(const A&)>);
+static_assert(equal<function_type_of<decltype(pipeline_front<&A::f, &sum, &minus>)>,
+                    int(const A&, int, int)>);
+static_assert(equal<function_type_of<decltype(pipeline_front<&make_converts_to_a, &A::g3>)>,
+                    int(int)>);
+static_assert(equal<function_type_of<decltype(pipeline_back<&minus, &sum, &A::g3>)>,
+                    int(const A&, int, int, int)>);
+static_assert(is_noexcept<decltype(pipeline<&make_move_only, &accepts_move_only>)>);
+static_assert(is_noexcept<decltype(pipeline<&f_no_except, &f_no_except, &f_no_except>)>);
+static_assert(!is_noexcept<decltype(pipeline<&f_no_except, &int_identity, &f_no_except>)>);
+static_assert(pipeline<&f>() == 2);
+static_assert(pipeline<&f, &int_identity, &int_identity>() == 2);
+static_assert(pipeline<&A::f, &int_identity>(A{}) == 1);
+static_assert(pipeline<&make_converts_to_a, &accepts_a>() == 4);
+static_assert(pipeline<&make_move_only, &accepts_move_only>() == 5);
+static_assert(pipeline_front<&minus, &sum, &minus>(4, 3, 2, 1) == 2);
+static_assert(pipeline_front<&minus, &sum, &minus>(4, 3, 2, 1) ==
+              compose_front<&minus, compose_front<&sum, &minus>>(4, 3, 2, 1));
+static_assert(pipeline_back<&minus, &sum, &minus>(4, 3, 2, 1) == 0);
+static_assert(pipeline_back<&minus, &sum, &minus>(4, 3, 2, 1) ==
+              compose_back<&minus, compose_back<&sum, &minus>>(4, 3, 2, 1));
+#ifdef STATIC_FUNCTIONAL_FUSION_REGISTRY
+static_assert(detail::is_fused<pipeline<&f, &int_identity>>);
+static_assert(pipeline<bind_back<&moves_of, 3>, &int_identity>(CountsMoves{}) == 1);
+static_assert(compose<&int_identity, pipeline<bind_back<&moves_of, 3>>>(CountsMoves{}) == 1);
+static_assert(pipeline<&make_counts_moves, bind_back<&moves_of, 3>>() == 1);
+#endif
+
+static_assert(dispatchable<int(int)>);
+static_assert(dispatchable<int(int, int), int(int), int()>);
+static_assert(dispatchable<int(ConvertsToA), int(A)>);
+static_assert(!dispatchable<int(A), int(ConvertsToA)>);
+static_assert(dispatchable<void(int), int(int)>);
+static_assert(!dispatchable<int(int), void(int)>);
+static_assert(!dispatchable<int(int), int(A)>);
+static_assert(!dispatchable<int(int), int(int, NotDefaultConstructible)>);
+static_assert(equal<function_type_of<decltype(dispatch_table<&sum, &minus>)>,
+                    int(std::size_t, int, int)>);
+static_assert(equal<function_type_of<decltype(dispatch_table<&A::f, &accepts_a>)>,
+                    int(std::size_t, const A&)>);
+static_assert(equal<function_type_of<decltype(dispatch_table_or<&int_identity, &f>)>,
+                    int(std::size_t, int)>);
+static_assert(is_noexcept<decltype(dispatch_table<&f_no_except, &f_no_except>)>);
+static_assert(!is_noexcept<decltype(dispatch_table<&f_no_except, &f2>)>);
+static_assert(!is_noexcept<decltype(dispatch_table_or<&f2, &f_no_except>)>);
+static_assert(dispatch_table<&sum, &minus>(0, 4, 3) == 7);
+static_assert(dispatch_table<&sum, &minus>(1, 4, 3) == 1);
+static_assert(dispatch_table<&int_identity, &f, &f2>(0, 5) == 5);
+static_assert(dispatch_table<&int_identity, &f, &f2>(1, 5) == 2);
+static_assert(dispatch_table<&A::f, &accepts_a>(1, A{}) == 4);
+static_assert(dispatch_table<&accepts_move_only, &accepts_move_only>(1, MoveOnly{}) == 5);
+static_assert(dispatch_table_or<&minus>(0, 4, 3) == 1);
+static_assert(dispatch_table_or<&minus, &sum>(0, 4, 3) == 7);
+static_assert(dispatch_table_or<&minus, &sum>(1, 4, 3) == 1);
+static_assert(dispatch_table_or<&minus, &sum>(100, 4, 3) == 1);
+
+static_assert(type_switchable<list<char, int>, SizeOfPlus>);
+static_assert(type_switchable<list<char, int>, AlignOf>);
+static_assert(!type_switchable<list<>, SizeOfPlus>);
+static_assert(!type_switchable<list<char, int>, NoHandler>);
+static_assert(!type_switchable<list<char, int>, TakesPointer>);
+static_assert(!type_switchable<int, SizeOfPlus>);
+static_assert(type_switchable_or<list<>, SizeOfPlus, decltype(&unknown_type)>);
+static_assert(type_switchable_or<list<char, int>, SizeOfPlus, decltype(&unknown_type)>);
+static_assert(!type_switchable_or<list<char, int>, TakesPointer, decltype(&unknown_type)>);
+static_assert(equal<decltype(type_switch<list<char, int>, SizeOfPlus>),
+                    std::size_t (*const)(std::size_t, std::size_t) noexcept>);
+static_assert(equal<decltype(type_switch<list<char, int>, AlignOf>), int (*const)(std::size_t)>);
+static_assert(equal<decltype(type_switch_or<list<char>, SizeOfPlus, &unknown_type>),
+                    std::size_t (*const)(std::size_t, std::size_t) noexcept>);
+static_assert(type_switch<list<char, int, double>, SizeOfPlus>(0, 1) == sizeof(char) + 1);
+static_assert(type_switch<list<char, int, double>, SizeOfPlus>(2, 1) == sizeof(double) + 1);
+static_assert(type_switch<list<char, long long>, AlignOf>(1) == alignof(long long));
+static_assert(type_switch_or<list<char, int>, SizeOfPlus, &unknown_type>(1, 1) == sizeof(int) + 1);
+static_assert(type_switch_or<list<char, int>, SizeOfPlus, &unknown_type>(2, 1) == 0);
+
+static_assert(specializable<int(int, int), 0u>);
+static_assert(specializable<int(int, int), 1u, int, short>);
+static_assert(specializable<int(Channels, int), 0u, Channels>);
+static_assert(specializable<int(const int&), 0u, int>);
+static_assert(specializable<decltype(&A::g3), 1u, int>);
+static_assert(!specializable<int(int, int), 2u, int>);
+static_assert(!specializable<int(Channels, int), 0u, int>);
+static_assert(!specializable<int(int&), 0u, int>);
+static_assert(!specializable<int(A), 0u, A>);
+static_assert(!specializable<int(int), 0u, A>);
+static_assert(equal<decltype(specialize<&minus, 1u, 1, 2, 4>), int (*const)(int, int)>);
+static_assert(equal<decltype(specialize<&scale, 0u, Channels::kMono, Channels::kStereo>),
+                    int (*const)(Channels, int)>);
+static_assert(equal<decltype(specialize<&f_no_except, 0u, 1>), int (*const)(int) noexcept>);
+static_assert(specialize<&minus, 0u> == &minus);
+static_assert(detail::specialize_f<&minus, list<int>, list<int>, 5>::f(7, 0) == 2);
+static_assert(detail::specialize_f<&minus, list<>, list<int, int>, 5>::f(0, 3) == 2);
+static_assert(specialize<&minus, 1u, 1, 2, 4>(7, 1) == 6);
+static_assert(specialize<&minus, 1u, 1, 2, 4>(7, 4) == 3);
+static_assert(specialize<&minus, 1u, 1, 2, 4>(7, 3) == 4);
+static_assert(specialize<&minus, 1u, 1, 2, 4>(7, -1) == 8);
+static_assert(specialize<&minus, 0u, -2, 2, 2>(-2, 1) == -3);
+static_assert(specialize<&minus, 0u, -100000, 100000>(-100000, 1) == -100001);
+static_assert(specialize<&minus, 0u, -100000, 100000>(100000, 1) == 99999);
+static_assert(specialize<&minus, 0u, -100000, 100000>(5, 1) == 4);
+static_assert(
+    specialize<&scale, 0u, Channels::kMono, Channels::kSurround>(Channels::kSurround, 2) == 12);
+static_assert(specialize<&scale, 0u, Channels::kMono>(Channels::kStereo, 2) == 4);
+static_assert(specialize<&A::g3, 1u, 3>(A{}, 3) == 3);
+
+static_assert(tabulatable<int(int), int, int>);
+static_assert(tabulatable<bool(char), char, char>);
+static_assert(tabulatable<int(Channels, int), Channels, Channels, int, int>);
+static_assert(tabulatable<int(const int&), int, int>);
+static_assert(!tabulatable<int(), int, int>);
+static_assert(!tabulatable<void(int), int, int>);
+static_assert(!tabulatable<int(int), int>);
+static_assert(!tabulatable<int(int, int), int, int>);
+static_assert(!tabulatable<int(A), A, A>);
+static_assert(!tabulatable<int(Channels), int, int>);
+static_assert(!tabulatable<NotDefaultConstructible(int), int, int>);
+static_assert(equal<decltype(tabulate<&square, 0, 15>), int (*const)(int) noexcept>);
+static_assert(equal<decltype(tabulate_or<&square, 0, 15>), int (*const)(int)>);
+static_assert(equal<decltype(tabulate_or<&is_space, '\0', '\x7f'>), bool (*const)(char) noexcept>);
+static_assert(equal<decltype(tabulate<&minus, 0, 3, 0, 3>), int (*const)(int, int) noexcept>);
+static_assert(tabulate<&square, 0, 15>(0) == 0);
+static_assert(tabulate<&square, 0, 15>(15) == 225);
+static_assert(tabulate<&square, -4, 4>(-3) == 9);
+static_assert(tabulate<&square, 7, 7>(7) == 49);
+static_assert(tabulate_or<&square, 0, 15>(16) == 256);
+static_assert(tabulate_or<&square, 0, 15>(-1) == 1);
+static_assert(tabulate<&is_space, '\0', '\x7f'>(' '));
+static_assert(!tabulate<&is_space, '\0', '\x7f'>('x'));
+static_assert(tabulate<&minus, 0, 3, -2, 2>(3, -2) == 5);
+static_assert(tabulate<&minus, 0, 3, -2, 2>(0, 2) == -2);
+static_assert(tabulate_or<&minus, 0, 3, -2, 2>(3, 3) == 0);
+static_assert(tabulate_or<&minus, 0, 3, -2, 2>(4, 2) == 2);
+static_assert(
+    tabulate<&scale, Channels::kMono, Channels::kSurround, 0, 3>(Channels::kStereo, 3) == 6);
+
+static_assert(batchable<int(int)>);
+static_assert(batchable<void(int, int)>);
+static_assert(batchable<int()>);
+static_assert(batchable<decltype(&A::f)>);
+static_assert(batchable<int(MoveOnly&&)>);
+static_assert(batchable<MoveOnly(int)>);
+static_assert(!batchable<int(MoveOnly)>);
+static_assert(!batchable<int>);
+static_assert(equal<function_type_of<decltype(batch<&int_identity>)>,
+                    void(const int*, int*, std::size_t)>);
+static_assert(equal<function_type_of<decltype(batch<&sum>)>,
+                    void(const int*, const int*, int*, std::size_t)>);
+static_assert(equal<function_type_of<decltype(batch<&g>)>, void(const int*, std::size_t)>);
+static_assert(equal<function_type_of<decltype(batch<&f>)>, void(int*, std::size_t)>);
+static_assert(equal<function_type_of<decltype(batch<&A::f>)>, void(const A*, int*, std::size_t)>);
+static_assert(equal<function_type_of<decltype(batch<&A::g>)>,
+                    void(A*, const int*, std::size_t)>);
+static_assert(equal<function_type_of<decltype(batch<&A::move_this>)>, void(A*, int*, std::size_t)>);
+static_assert(equal<function_type_of<decltype(batch<&A::accepts_move_only>)>,
+                    void(const A*, MoveOnly*, int*, std::size_t)>);
+static_assert(is_noexcept<decltype(batch<&f_no_except>)>);
+static_assert(!is_noexcept<decltype(batch<&int_identity>)>);
+static_assert([] {
+  int in[] = {1, 2, 3};
+  int out[] = {0, 0, 0};
+  batch<compose<&int_identity, bind_front<&sum, 1>>>(in, out, 3);
+  return out[0] == 2 && out[1] == 3 && out[2] == 4;
+}());
+static_assert([] {
+  int a[] = {4, 5};
+  int b[] = {1, 3};
+  int out[] = {0, 0};
+  batch<&minus>(a, b, out, 2);
+  return out[0] == 3 && out[1] == 2;
+}());
+static_assert([] {
+  A in[] = {A{}, A{}};
+  int out[] = {0, 0};
+  batch<&A::move_this>(in, out, 2);
+  return out[0] == 6 && out[1] == 6;
+}());
+
+template <string_literal S>
+inline constexpr std::string_view literal_view = S.view();
+static_assert(literal_view<"abc"> == "abc");
+static_assert(literal_view<""> == "");
+static_assert(equal<decltype(string_literal{"abc"}), string_literal<4>>);
+
 }  // namespace
 }  // namespace sfn
 
 int main() {
   sfn::sequence<sfn::bind_back<sfn::cast<void(unsigned long), &sfn::g>, 1ul>,
                 sfn::bind_front<&sfn::A::f, sfn::A{}>>();
-  sfn::reinterpret<int(void*), &sfn::c_callback>(nullptr);
+  sfn::reinterpret<int(void*), &sfn::c_mutable_callback>(nullptr);
   sfn::reinterpret<int(const void*), &sfn::c_const_callback>(nullptr);
   sfn::reinterpret<void*(int), &sfn::c_fetch_callback>(0);
   sfn::reinterpret<const void*(int), &sfn::c_const_fetch_callback>(0);
   sfn::A a;
   sfn::reinterpret<int(void*, int), &sfn::A::c_callback>((void*)&a, 0);
+  if (sfn::c_callback<&sfn::A::c_callback>(&a, 8) != 8 ||
+      sfn::c_callback_back<&sfn::A::c_callback>(9, &a) != 9 ||
+      sfn::c_callback<&sfn::A::f>(&a) != 1 || sfn::c_callback<&sfn::A::move_this>(&a) != 6 ||
+      sfn::c_callback_back<&sfn::A::no_except>(0, &a) != 5 ||
+      sfn::c_callback<&sfn::A::accepts_move_only>(&a, sfn::MoveOnly{}) != 4) {
+    return 1;
+  }
   return 0;
 }
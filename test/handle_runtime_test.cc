@@ -0,0 +1,123 @@
+// A small capacity, so that running out of handles can be tested. Index 0 is the null handle, so
+// there is room for 7 functions of each signature.
+#define STATIC_FUNCTIONAL_HANDLE_CAPACITY 8
+
+#include "test/check.h"
+#include <sfn/handle.h>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace sfn {
+namespace {
+
+struct Timer {
+  std::uint32_t fired = 0;
+  void fire(std::uint32_t id) {
+    fired = id;
+  }
+};
+
+void on_timeout(Timer& timer, std::uint32_t id) {
+  timer.fired = id + 1u;
+}
+void on_retry(Timer& timer, std::uint32_t id) noexcept {
+  timer.fired = id + 2u;
+}
+
+using callback = handle<void(Timer&, std::uint32_t), std::uint16_t>;
+using wide_callback = handle<void(Timer&, std::uint32_t)>;
+
+void test_of() {
+  auto timeout = callback::of<&on_timeout>();
+  SFN_CHECK(timeout);
+  SFN_CHECK(timeout.index() != 0u);
+  SFN_CHECK(callback::of<&on_timeout>() == timeout);
+  auto retry = callback::of<&on_retry>();
+  SFN_CHECK(retry != timeout);
+  SFN_CHECK(callback::of<&on_retry>() == retry);
+
+  Timer timer;
+  timeout(timer, 10u);
+  SFN_CHECK(timer.fired == 11u);
+  retry(timer, 10u);
+  SFN_CHECK(timer.fired == 12u);
+  callback::of<&Timer::fire>()(timer, 10u);
+  SFN_CHECK(timer.fired == 10u);
+  SFN_CHECK(timeout.get() == &on_timeout);
+  SFN_CHECK(!callback{}.get());
+}
+
+void test_shared_entries() {
+  // Different ways of naming the same function, and different index types, share an entry.
+  auto timeout = callback::of<&on_timeout>();
+  SFN_CHECK((callback::of<cast<void(Timer&, std::uint32_t), &on_timeout>>() == timeout));
+  SFN_CHECK(wide_callback::of<&on_timeout>().index() == timeout.index());
+  SFN_CHECK((handle<void(Timer&, std::uint32_t), std::uint64_t>::of<&on_timeout>().index() ==
+             timeout.index()));
+  SFN_CHECK(wide_callback::of<&on_retry>().index() == callback::of<&on_retry>().index());
+}
+
+template <int I>
+int numbered(int x) {
+  return x + I;
+}
+
+template <int... I>
+std::vector<handle<int(int)>> register_numbered(std::integer_sequence<int, I...>) {
+  return {handle<int(int)>::of<&numbered<I>>()...};
+}
+
+void test_capacity() {
+  auto handles = register_numbered(std::make_integer_sequence<int, 7>{});
+  for (int i = 0; i < 7; ++i) {
+    SFN_CHECK(handles[static_cast<std::size_t>(i)].index() == static_cast<std::uint32_t>(i + 1));
+    SFN_CHECK(handles[static_cast<std::size_t>(i)](100) == 100 + i);
+  }
+  for (int attempt = 0; attempt < 2; ++attempt) {
+    bool threw = false;
+    try {
+      (void)handle<int(int)>::of<&numbered<7>>();
+    } catch (const std::length_error&) {
+      threw = true;
+    }
+    SFN_CHECK(threw);
+  }
+  // Existing handles are unaffected.
+  SFN_CHECK(handle<int(int)>::of<&numbered<3>>() == handles[3]);
+  SFN_CHECK(handles[6](100) == 106);
+}
+
+long concurrent_target(long x) {
+  return x * 2;
+}
+
+void test_concurrent_registration() {
+  constexpr int threads = 4;
+  handle<long(long)> handles[threads];
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back(
+        [&handles, t] { handles[t] = handle<long(long)>::of<&concurrent_target>(); });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  for (auto h : handles) {
+    SFN_CHECK(h == handles[0]);
+    SFN_CHECK(h(21) == 42);
+  }
+}
+
+}  // namespace
+}  // namespace sfn
+
+int main() {
+  sfn::test_of();
+  sfn::test_shared_entries();
+  sfn::test_capacity();
+  sfn::test_concurrent_registration();
+  return 0;
+}
@@ -0,0 +1,54 @@
+#include <sfn/handle.h>
+#include <cstdint>
+#include <type_traits>
+
+namespace sfn {
+namespace {
+
+template <typename T, typename U>
+inline constexpr bool equal = std::is_same_v<T, U>;
+
+struct Timer {
+  void fire(std::uint32_t) {}
+};
+
+void on_timeout(Timer&, std::uint32_t) {}
+void on_retry(Timer&, std::uint32_t) noexcept {}
+void on_tick(Timer&) {}
+int on_pointer(int*) {
+  return 0;
+}
+
+template <typename Handle, auto F>
+concept has_handle = requires { Handle::template of<F>(); };
+
+using callback = handle<void(Timer&, std::uint32_t), std::uint16_t>;
+using wide_callback = handle<void(Timer&, std::uint32_t)>;
+
+static_assert(handle_index<std::uint16_t>);
+static_assert(handle_index<std::uint32_t>);
+static_assert(handle_index<std::uint64_t>);
+static_assert(!handle_index<std::uint8_t>);
+static_assert(!handle_index<bool>);
+static_assert(!handle_index<int>);
+
+static_assert(sizeof(callback) == 2u);
+static_assert(sizeof(wide_callback) == 4u);
+static_assert(std::is_trivially_copyable_v<callback>);
+static_assert(equal<wide_callback::index_type, std::uint32_t>);
+static_assert(!callback{});
+static_assert(callback{}.index() == 0u);
+static_assert(callback{} == callback{});
+
+static_assert(has_handle<callback, &on_timeout>);
+static_assert(has_handle<callback, &on_retry>);
+static_assert(has_handle<callback, &on_tick>);
+static_assert(has_handle<callback, &Timer::fire>);
+static_assert(has_handle<callback, bind_back<&on_timeout, 3u>>);
+static_assert(!has_handle<callback, &on_pointer>);
+static_assert(equal<decltype(callback::of<&on_timeout>()), callback>);
+static_assert(equal<decltype(callback{}.get()), void (*)(Timer&, std::uint32_t)>);
+static_assert(equal<decltype(callback{}(std::declval<Timer&>(), 1u)), void>);
+
+}  // namespace
+}  // namespace sfn
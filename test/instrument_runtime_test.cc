@@ -0,0 +1,151 @@
+#include "test/check.h"
+#include <sfn/instrument.h>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace sfn {
+namespace {
+
+struct Fast {
+  static constexpr std::string_view name = "fast";
+};
+struct Slow {
+  static constexpr std::string_view name = "slow";
+};
+struct Throwing {
+  static constexpr std::string_view name = "throwing";
+};
+struct Idle {
+  static constexpr std::string_view name = "idle";
+};
+struct Disabled {
+  static constexpr std::string_view name = "disabled";
+  static constexpr bool enabled = false;
+};
+
+int add(int x, int y) {
+  return x + y;
+}
+
+void test_quantiles() {
+  instrument_stats stats;
+  for (std::uint64_t ns : {100u, 200u, 300u, 400u, 100000u}) {
+    ++stats.histogram[instrument_bucket(ns)];
+    ++stats.calls;
+  }
+  SFN_CHECK(stats.quantile_ns(0.) == instrument_bucket_min(instrument_bucket(100)));
+  SFN_CHECK(stats.quantile_ns(.5) == instrument_bucket_min(instrument_bucket(300)));
+  SFN_CHECK(stats.quantile_ns(.79) == instrument_bucket_min(instrument_bucket(400)));
+  SFN_CHECK(stats.quantile_ns(.99) == instrument_bucket_min(instrument_bucket(100000)));
+  SFN_CHECK(stats.quantile_ns(1.) == instrument_bucket_min(instrument_bucket(100000)));
+}
+
+void test_disabled() {
+  SFN_CHECK((instrument<&add, Disabled>(1, 2) == 3));
+  SFN_CHECK((instrument_stats_of<&add, Disabled>().calls == 0u));
+}
+
+#ifndef STATIC_FUNCTIONAL_DISABLE_INSTRUMENT
+void sleep_ms(int ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds{ms});
+}
+void throws(int) {
+  throw 0;
+}
+
+// Taking the address is enough to register the function.
+[[maybe_unused]] auto* idle = instrument<&add, Idle>;
+
+std::uint64_t histogram_total(const instrument_stats& stats) {
+  std::uint64_t total = 0;
+  for (auto count : stats.histogram) {
+    total += count;
+  }
+  return total;
+}
+
+void test_counts() {
+  constexpr int kThreads = 4;
+  constexpr int kCalls = 1000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([] {
+      for (int i = 0; i < kCalls; ++i) {
+        SFN_CHECK((instrument<&add, Fast>(i, 1) == i + 1));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  // Counters of threads that have exited are still included.
+  auto stats = instrument_stats_of<&add, Fast>();
+  SFN_CHECK(stats.calls == kThreads * kCalls);
+  SFN_CHECK(histogram_total(stats) == stats.calls);
+}
+
+void test_latency() {
+  for (int i = 0; i < 5; ++i) {
+    instrument<&sleep_ms, Slow>(2);
+  }
+  auto stats = instrument_stats_of<&sleep_ms, Slow>();
+  SFN_CHECK(stats.calls == 5u);
+  SFN_CHECK(histogram_total(stats) == 5u);
+  SFN_CHECK(stats.total_ns >= 10'000'000u);
+  // Quantiles are bucket lower bounds, which are within 25% of the true latency.
+  SFN_CHECK(stats.quantile_ns(0.) >= 1'500'000u);
+  SFN_CHECK(stats.quantile_ns(.5) >= 1'500'000u);
+  SFN_CHECK(stats.quantile_ns(1.) <= stats.total_ns);
+  SFN_CHECK(stats.quantile_ns(0.) <= stats.quantile_ns(1.));
+}
+
+void test_throwing() {
+  bool caught = false;
+  try {
+    instrument<&throws, Throwing>(0);
+  } catch (int) {
+    caught = true;
+  }
+  SFN_CHECK(caught);
+  SFN_CHECK((instrument_stats_of<&throws, Throwing>().calls == 1u));
+}
+
+void test_registry() {
+  std::size_t fast = 0;
+  std::size_t slow = 0;
+  std::size_t idle = 0;
+  for (const auto& info : instrumented()) {
+    SFN_CHECK(info.name != "disabled");
+    if (info.name == "fast") {
+      ++fast;
+      SFN_CHECK(info.stats.calls == 4000u);
+    } else if (info.name == "slow") {
+      ++slow;
+      SFN_CHECK(info.stats.calls == 5u);
+    } else if (info.name == "idle") {
+      ++idle;
+      SFN_CHECK(info.stats.calls == 0u);
+    }
+  }
+  SFN_CHECK(fast == 1u && slow == 1u && idle == 1u);
+}
+#endif
+
+}  // namespace
+}  // namespace sfn
+
+int main() {
+  sfn::test_quantiles();
+  sfn::test_disabled();
+#ifndef STATIC_FUNCTIONAL_DISABLE_INSTRUMENT
+  sfn::test_counts();
+  sfn::test_latency();
+  sfn::test_throwing();
+  sfn::test_registry();
+#endif
+  return 0;
+}
@@ -0,0 +1,64 @@
+#include <sfn/instrument.h>
+#include <memory>
+#include <type_traits>
+
+namespace sfn {
+namespace {
+
+template <typename T, typename U>
+inline constexpr bool equal = std::is_same_v<T, U>;
+
+struct Tag {
+  static constexpr const char* name = "tag";
+};
+struct DisabledTag {
+  static constexpr std::string_view name = "disabled";
+  static constexpr bool enabled = false;
+};
+struct NoName {};
+
+struct A {
+  int f(int x) const noexcept {
+    return x;
+  }
+};
+
+void f(int) {}
+int& g(int&& x) {
+  return x;
+}
+std::unique_ptr<int> h(std::unique_ptr<int> p) {
+  return p;
+}
+
+static_assert(instrument_tag<Tag>);
+static_assert(instrument_tag<DisabledTag>);
+static_assert(!instrument_tag<NoName>);
+
+static_assert(instrument_bucket(0) == 0u);
+static_assert(instrument_bucket(3) == 3u);
+static_assert(instrument_bucket(4) == 4u);
+static_assert(instrument_bucket(7) == 7u);
+static_assert(instrument_bucket(8) == 8u);
+static_assert(instrument_bucket(9) == 8u);
+static_assert(instrument_bucket(10) == 9u);
+static_assert(instrument_bucket(~std::uint64_t{0}) == instrument_buckets - 1u);
+static_assert(instrument_bucket_min(instrument_bucket(1000)) <= 1000u);
+static_assert(instrument_bucket_min(instrument_bucket(1000) + 1u) > 1000u);
+static_assert(instrument_stats{}.quantile_ns(.5) == 0u);
+
+static_assert(equal<decltype(instrument<&f, Tag>), void (*const)(int)>);
+static_assert(equal<decltype(instrument<&g, Tag>), int& (*const)(int&&)>);
+static_assert(equal<decltype(instrument<&h, Tag>),
+                    std::unique_ptr<int> (*const)(std::unique_ptr<int>)>);
+static_assert(equal<decltype(instrument<&A::f, Tag>), int (*const)(const A&, int) noexcept>);
+#ifndef STATIC_FUNCTIONAL_DISABLE_INSTRUMENT
+static_assert(instrument<&f, Tag> != &f);
+#else
+static_assert(instrument<&f, Tag> == &f);
+#endif
+static_assert(instrument<&f, DisabledTag> == &f);
+static_assert(equal<decltype(instrument_stats_of<&f, Tag>), instrument_stats (*const)() noexcept>);
+
+}  // namespace
+}  // namespace sfn
@@ -0,0 +1,123 @@
+#include "test/check.h"
+#include <sfn/memoize.h>
+#include <atomic>
+#include <cstdint>
+#include <initializer_list>
+#include <thread>
+#include <vector>
+
+namespace sfn {
+namespace {
+
+template <int Id>
+std::atomic<int> calls = 0;
+
+template <int Id>
+int counted(int x) {
+  ++calls<Id>;
+  return x * 3 + 1;
+}
+
+void test_hits_and_misses() {
+  auto* f = memoize<&counted<0>, 64>;
+  SFN_CHECK(f(1) == 4);
+  SFN_CHECK(f(1) == 4);
+  SFN_CHECK(f(2) == 7);
+  SFN_CHECK(f(1) == 4);
+  SFN_CHECK(calls<0> == 2);
+  auto stats = memoize_stats_of<&counted<0>, 64>();
+  SFN_CHECK(stats.hits == 2u);
+  SFN_CHECK(stats.misses == 2u);
+}
+
+long zero_calls = 0;
+long zero() {
+  return ++zero_calls;
+}
+
+void test_no_arguments() {
+  SFN_CHECK((memoize<&zero, 1>() == 1));
+  SFN_CHECK((memoize<&zero, 1>() == 1));
+  SFN_CHECK(zero_calls == 1);
+}
+
+// Calls f on each key and returns how many of them were cache hits.
+template <int Id, auto F>
+int hits(std::initializer_list<int> keys) {
+  int before = calls<Id>;
+  for (int key : keys) {
+    SFN_CHECK(F(key) == key * 3 + 1);
+  }
+  return static_cast<int>(keys.size()) - (calls<Id> - before);
+}
+
+void test_clock_eviction() {
+  // A capacity of 4 is a single set, so every key competes for the same 4 ways.
+  constexpr auto f = memoize<&counted<1>, 4>;
+  SFN_CHECK((hits<1, f>({0, 1, 2, 3}) == 0));
+  SFN_CHECK((hits<1, f>({0, 1, 2, 3}) == 4));
+  // Every entry is referenced, so the hand clears them all and evicts the first.
+  SFN_CHECK((hits<1, f>({4}) == 0));
+  SFN_CHECK((hits<1, f>({1}) == 1));
+  // 1 was referenced again since its bit was cleared, so 2 is evicted next.
+  SFN_CHECK((hits<1, f>({5}) == 0));
+  SFN_CHECK((hits<1, f>({1, 3, 4, 5}) == 4));
+  SFN_CHECK((hits<1, f>({2}) == 0));
+}
+
+void test_lru_eviction() {
+  constexpr auto f = memoize<&counted<2>, 4, memoize_eviction::kLru>;
+  SFN_CHECK((hits<2, f>({0, 1, 2, 3}) == 0));
+  SFN_CHECK((hits<2, f>({0}) == 1));
+  // 1 is now the least recently used.
+  SFN_CHECK((hits<2, f>({4}) == 0));
+  SFN_CHECK((hits<2, f>({0, 2, 3, 4}) == 4));
+  SFN_CHECK((hits<2, f>({1}) == 0));
+}
+
+void test_capacity_rounding() {
+  // 6 is rounded up to two sets of 4, and consecutive keys alternate between them.
+  constexpr auto f = memoize<&counted<3>, 6>;
+  SFN_CHECK((hits<3, f>({0, 1, 2, 3, 4, 5, 6, 7}) == 0));
+  SFN_CHECK((hits<3, f>({0, 1, 2, 3, 4, 5, 6, 7}) == 8));
+}
+
+std::uint64_t mix(std::uint64_t a, std::uint64_t b) noexcept {
+  return (a * 0x9e3779b97f4a7c15ull) ^ (b + 0x632be59bd9b4e019ull);
+}
+
+void test_concurrent() {
+  // Many more keys than entries, so that readers race with writers evicting the same slots.
+  constexpr int kThreads = 4;
+  constexpr std::uint64_t kIterations = 200000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([t] {
+      for (std::uint64_t i = 0; i < kIterations; ++i) {
+        std::uint64_t a = (i * 7u + t) % 97u;
+        std::uint64_t b = a % 5u;
+        SFN_CHECK((memoize<&mix, 32>(a, b) == mix(a, b)));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  auto stats = memoize_stats_of<&mix, 32>();
+  SFN_CHECK(stats.hits + stats.misses == kThreads * kIterations);
+  SFN_CHECK(stats.hits > 0u);
+  SFN_CHECK(stats.misses >= 97u);
+}
+
+}  // namespace
+}  // namespace sfn
+
+int main() {
+  sfn::test_hits_and_misses();
+  sfn::test_no_arguments();
+  sfn::test_clock_eviction();
+  sfn::test_lru_eviction();
+  sfn::test_capacity_rounding();
+  sfn::test_concurrent();
+  return 0;
+}
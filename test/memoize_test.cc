@@ -0,0 +1,68 @@
+#include <sfn/memoize.h>
+#include <string>
+#include <type_traits>
+
+namespace sfn {
+namespace {
+
+template <typename T, typename U>
+inline constexpr bool equal = std::is_same_v<T, U>;
+
+struct NotHashable {
+  bool operator==(const NotHashable&) const = default;
+};
+struct A {
+  int f(int x) const {
+    return x;
+  }
+};
+
+int f(int x) {
+  return x;
+}
+double g(int x, float y, char z) noexcept {
+  return x + y + z;
+}
+long h() {
+  return 0;
+}
+void v(int) {}
+int& r(int) {
+  static int x = 0;
+  return x;
+}
+int cr(const int& x) {
+  return x;
+}
+int s(std::string x) {
+  return static_cast<int>(x.size());
+}
+int n(NotHashable) {
+  return 0;
+}
+NotHashable rn(int) {
+  return {};
+}
+
+static_assert(memoizable<decltype(&f)>);
+static_assert(memoizable<decltype(&g)>);
+static_assert(memoizable<decltype(&h)>);
+static_assert(memoizable<int(long, bool)>);
+static_assert(!memoizable<decltype(&v)>);
+static_assert(!memoizable<decltype(&r)>);
+static_assert(!memoizable<decltype(&cr)>);
+static_assert(!memoizable<decltype(&s)>);
+static_assert(!memoizable<decltype(&n)>);
+static_assert(!memoizable<decltype(&rn)>);
+static_assert(!memoizable<decltype(&A::f)>);
+
+static_assert(equal<decltype(memoize<&f, 64>), int (*const)(int)>);
+static_assert(equal<decltype(memoize<&g, 1>), double (*const)(int, float, char) noexcept>);
+static_assert(equal<decltype(memoize<&h, 3, memoize_eviction::kLru>), long (*const)()>);
+static_assert(
+    equal<decltype(memoize<bind_front<&g, 1>, 64>), double (*const)(float, char) noexcept>);
+static_assert(memoize<&f, 64> != memoize<&f, 64, memoize_eviction::kLru>);
+static_assert(equal<decltype(memoize_stats_of<&f, 64>), memoize_stats (*const)() noexcept>);
+
+}  // namespace
+}  // namespace sfn
@@ -0,0 +1,72 @@
+#include "test/check.h"
+#include <sfn/multiversion.h>
+#include <cstddef>
+
+namespace sfn {
+namespace {
+
+int v0(int x) {
+  return x;
+}
+int v1(int x) {
+  return x + 10;
+}
+int v2(int x) {
+  return x + 20;
+}
+
+// The variant multiversion picks on this machine out of n, as documented.
+std::size_t best_of(std::size_t n) {
+  auto level = static_cast<std::size_t>(detected_cpu_level());
+  return level < n ? n - 1u - level : 0u;
+}
+
+void test_select_and_reset() {
+  constexpr auto f = multiversion<&v0, &v1, &v2>;
+  constexpr auto selected = multiversion_selected<&v0, &v1, &v2>;
+  constexpr auto select = multiversion_select<&v0, &v1, &v2>;
+  constexpr auto reset = multiversion_reset<&v0, &v1, &v2>;
+  auto best = best_of(3u);
+  SFN_CHECK(selected() == best);
+  SFN_CHECK(f(1) == 1 + 10 * static_cast<int>(best));
+  // A copy of the pointer follows the selection, since it points at the dispatcher.
+  int (*volatile g)(int) = f;
+  for (std::size_t i = 0; i < 3u; ++i) {
+    SFN_CHECK(select(i));
+    SFN_CHECK(selected() == i);
+    SFN_CHECK(g(1) == 1 + 10 * static_cast<int>(i));
+  }
+  SFN_CHECK(!select(3u));
+  SFN_CHECK(selected() == 2u);
+  SFN_CHECK(g(1) == 21);
+  reset();
+  SFN_CHECK(selected() == best);
+  SFN_CHECK(g(1) == 1 + 10 * static_cast<int>(best));
+}
+
+// Selected during static initialization, in no particular order relative to multiversion's own
+// initialization, which must not override it.
+const std::size_t chosen_early = 1u - best_of(2u);
+const bool selected_early = multiversion_select<&v2, &v1>(chosen_early);
+
+void test_select_before_initialization() {
+  SFN_CHECK(selected_early);
+  SFN_CHECK((multiversion_selected<&v2, &v1>() == chosen_early));
+  SFN_CHECK((multiversion<&v2, &v1>(1) == (chosen_early ? 11 : 21)));
+}
+
+void test_identical_variants() {
+  SFN_CHECK((multiversion_select<&v0, &v0>(1u)));
+  SFN_CHECK((multiversion_selected<&v0, &v0>() == 0u));
+  SFN_CHECK((multiversion<&v0, &v0>(1) == 1));
+}
+
+}  // namespace
+}  // namespace sfn
+
+int main() {
+  sfn::test_select_and_reset();
+  sfn::test_select_before_initialization();
+  sfn::test_identical_variants();
+  return 0;
+}
@@ -0,0 +1,58 @@
+#include <sfn/multiversion.h>
+#include <cstddef>
+#include <type_traits>
+
+namespace sfn {
+namespace {
+
+template <typename T, typename U>
+inline constexpr bool equal = std::is_same_v<T, U>;
+
+struct A {
+  int f(int x) const {
+    return x;
+  }
+};
+
+int f_avx512(int x) {
+  return x;
+}
+int f_avx2(int x) {
+  return x;
+}
+int f_scalar(int x) noexcept {
+  return x;
+}
+int f_accepts_a(const A&, int) {
+  return 0;
+}
+long f_long(short) {
+  return 0;
+}
+int f_pointer(int*) {
+  return 0;
+}
+
+static_assert(multiversionable<decltype(&f_scalar)>);
+static_assert(multiversionable<decltype(&f_avx2), decltype(&f_scalar)>);
+static_assert(multiversionable<decltype(&f_avx512), decltype(&f_avx2), decltype(&f_scalar)>);
+static_assert(multiversionable<int(int), decltype(&f_long)>);
+static_assert(multiversionable<decltype(&A::f), decltype(&f_accepts_a)>);
+static_assert(!multiversionable<int(int), int(int), int(int), int(int)>);
+static_assert(!multiversionable<int(int), decltype(&f_pointer)>);
+static_assert(!multiversionable<int>);
+
+static_assert(equal<decltype(multiversion<&f_avx512, &f_avx2, &f_scalar>), int (*const)(int)>);
+static_assert(equal<decltype(multiversion<&f_scalar>), int (*const)(int) noexcept>);
+static_assert(equal<decltype(multiversion<&A::f, &f_accepts_a>), int (*const)(const A&, int)>);
+static_assert(equal<decltype(multiversion<&f_avx2, &f_long>), int (*const)(int)>);
+static_assert(multiversion<&f_avx2, &f_scalar> != multiversion<&f_scalar, &f_avx2>);
+static_assert(equal<decltype(multiversion_selected<&f_avx2, &f_scalar>),
+                    std::size_t (*const)() noexcept>);
+static_assert(equal<decltype(multiversion_select<&f_avx2, &f_scalar>),
+                    bool (*const)(std::size_t) noexcept>);
+static_assert(equal<decltype(multiversion_reset<&f_avx2, &f_scalar>), void (*const)() noexcept>);
+static_assert(equal<decltype(detected_cpu_level()), cpu_level>);
+
+}  // namespace
+}  // namespace sfn
@@ -0,0 +1,230 @@
+// Force a real pool even on single-core hosts, and a shallow queue so the inline fallback is hit.
+#define STATIC_FUNCTIONAL_PARALLEL_THREADS 4
+#define STATIC_FUNCTIONAL_PARALLEL_QUEUE_DEPTH 1
+#include "test/check.h"
+#include <sfn/parallel.h>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace sfn {
+namespace {
+
+struct error {
+  int id;
+};
+
+// Spins until flag is set, or gives up after a few seconds so that a broken pool fails the check
+// rather than hanging.
+bool wait_for(const std::atomic<bool>& flag) {
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{10};
+  while (!flag.load()) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+    std::this_thread::yield();
+  }
+  return true;
+}
+
+std::atomic<bool> forked_started = false;
+std::thread::id forked_thread;
+
+void forked(int& x) {
+  forked_thread = std::this_thread::get_id();
+  x += 1;
+  forked_started = true;
+}
+int last(int& x) {
+  // Only returns if the first function runs concurrently on another thread.
+  SFN_CHECK(wait_for(forked_started));
+  return x + 10;
+}
+
+void test_fork_join() {
+  SFN_CHECK(detail::thread_pool::get().size() == 3u);
+  int x = 0;
+  SFN_CHECK((parallel_sequence<&forked, &last>(x) == 11));
+  SFN_CHECK(x == 1);
+  SFN_CHECK(forked_thread != std::this_thread::get_id());
+}
+
+template <int Id>
+void throws(int) {
+  throw error{Id};
+}
+void nothing(int) {}
+
+template <auto F>
+int caught(int x) {
+  try {
+    F(x);
+  } catch (const error& e) {
+    return e.id;
+  }
+  return 0;
+}
+
+void test_rethrow_order() {
+  SFN_CHECK((caught<parallel_sequence<&throws<1>, &throws<2>, &nothing>>(0) == 1));
+  SFN_CHECK((caught<parallel_sequence<&nothing, &throws<2>, &throws<3>>>(0) == 2));
+  SFN_CHECK((caught<parallel_sequence<&throws<1>, &throws<3>>>(0) == 1));
+  SFN_CHECK((caught<parallel_sequence<&nothing, &nothing, &throws<3>>>(0) == 3));
+  SFN_CHECK((caught<parallel_sequence<&nothing, &nothing, &nothing>>(0) == 0));
+}
+
+std::atomic<bool> last_called = false;
+std::atomic<int> inline_count = 0;
+
+template <int I>
+void maybe_inline(std::thread::id caller) {
+  // With 3 pool threads and a queue depth of 1, only the first 3 forked functions are queued; the
+  // rest run on the calling thread during the fork, before the last function starts.
+  if (I >= 3) {
+    SFN_CHECK(std::this_thread::get_id() == caller);
+    SFN_CHECK(!last_called);
+    ++inline_count;
+  }
+}
+void mark_last(std::thread::id) {
+  last_called = true;
+}
+
+void test_inline_fallback() {
+  parallel_sequence<&maybe_inline<0>, &maybe_inline<1>, &maybe_inline<2>, &maybe_inline<3>,
+                    &maybe_inline<4>, &mark_last>(std::this_thread::get_id());
+  SFN_CHECK(inline_count == 2);
+  SFN_CHECK(last_called);
+}
+
+std::atomic<int> leaves = 0;
+
+void tree(int depth) {
+  if (!depth) {
+    ++leaves;
+    return;
+  }
+  parallel_sequence<&tree, &tree, &tree>(depth - 1);
+}
+
+void test_nested() {
+  tree(6);
+  SFN_CHECK(leaves == 729);
+}
+
+std::mutex threads_mutex;
+std::set<std::thread::id> batch_threads;
+
+// Takes a microsecond or so, so that a large batch is split into many chunks.
+long square(int x) {
+  thread_local bool seen = false;
+  if (!seen) {
+    seen = true;
+    std::lock_guard lock{threads_mutex};
+    batch_threads.insert(std::this_thread::get_id());
+  }
+  volatile long spin = 0;
+  for (int i = 0; i < 256; ++i) {
+    spin = spin + i;
+  }
+  return static_cast<long>(x) * x;
+}
+
+void test_batch() {
+  constexpr std::size_t n = 1u << 16;
+  std::vector<int> in(n);
+  std::vector<long> out(n + 1, -1);
+  for (std::size_t i = 0; i < n; ++i) {
+    in[i] = static_cast<int>(i);
+  }
+  // The first call measures the cost per element; the second uses the remembered estimate.
+  for (int run = 0; run < 2; ++run) {
+    parallel_batch<&square>(in.data(), out.data(), n);
+    for (std::size_t i = 0; i < n; ++i) {
+      SFN_CHECK(out[i] == static_cast<long>(i) * static_cast<long>(i));
+      out[i] = -1;
+    }
+    SFN_CHECK(out[n] == -1);
+  }
+  SFN_CHECK(batch_threads.size() > 1u);
+
+  parallel_batch<&square>(nullptr, nullptr, 0);
+  parallel_batch<&square>(in.data() + 5, out.data() + 5, 1);
+  SFN_CHECK(out[4] == -1 && out[5] == 25 && out[6] == -1);
+}
+
+std::atomic<int> visited = 0;
+
+void visit(int x) {
+  if (x == 40000) {
+    throw error{x};
+  }
+  ++visited;
+}
+
+void test_batch_throws() {
+  constexpr std::size_t n = 1u << 16;
+  std::vector<int> in(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    in[i] = static_cast<int>(i);
+  }
+  int id = 0;
+  try {
+    parallel_batch<&visit>(in.data(), n);
+  } catch (const error& e) {
+    id = e.id;
+  }
+  SFN_CHECK(id == 40000);
+  SFN_CHECK(visited < static_cast<int>(n));
+
+  // The pool is still usable afterwards.
+  in[40000] = 0;
+  visited = 0;
+  parallel_batch<&visit>(in.data(), n);
+  SFN_CHECK(visited == static_cast<int>(n));
+}
+
+std::atomic<bool> outer_started = false;
+std::thread::id outer_thread;
+
+void batch_from_worker(std::vector<int>& in, std::vector<long>& out) {
+  outer_thread = std::this_thread::get_id();
+  outer_started = true;
+  parallel_batch<&square>(in.data(), out.data(), in.size());
+}
+void wait_for_worker(std::vector<int>&, std::vector<long>&) {
+  // Keeps the calling thread busy so that the first function must run on a pool worker.
+  SFN_CHECK(wait_for(outer_started));
+}
+
+void test_batch_nested() {
+  constexpr std::size_t n = 1u << 14;
+  std::vector<int> in(n);
+  std::vector<long> out(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    in[i] = static_cast<int>(n - i);
+  }
+  parallel_sequence<&batch_from_worker, &wait_for_worker>(in, out);
+  SFN_CHECK(outer_thread != std::this_thread::get_id());
+  for (std::size_t i = 0; i < n; ++i) {
+    SFN_CHECK(out[i] == static_cast<long>(n - i) * static_cast<long>(n - i));
+  }
+}
+
+}  // namespace
+}  // namespace sfn
+
+int main() {
+  sfn::test_fork_join();
+  sfn::test_rethrow_order();
+  sfn::test_inline_fallback();
+  sfn::test_nested();
+  sfn::test_batch();
+  sfn::test_batch_throws();
+  sfn::test_batch_nested();
+  return 0;
+}
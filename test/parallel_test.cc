@@ -0,0 +1,51 @@
+#include <sfn/parallel.h>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+namespace sfn {
+namespace {
+
+template <typename T, typename U>
+inline constexpr bool equal = std::is_same_v<T, U>;
+
+struct A {
+  int f(int x) {
+    return x;
+  }
+};
+
+void f(int) {}
+int g(int x) {
+  return x;
+}
+long h(int x) noexcept {
+  return x;
+}
+int& r(int) {
+  static int x = 0;
+  return x;
+}
+void m(std::unique_ptr<int>) {}
+
+static_assert(equal<decltype(parallel_sequence<&f>), void (*const)(int)>);
+static_assert(equal<decltype(parallel_sequence<&g>), int (*const)(int)>);
+static_assert(equal<decltype(parallel_sequence<&f, &g>), int (*const)(int)>);
+static_assert(equal<decltype(parallel_sequence<&g, &f>), void (*const)(int)>);
+static_assert(equal<decltype(parallel_sequence<&f, &g, &r>), int& (*const)(int)>);
+static_assert(equal<decltype(parallel_sequence<&h, &h>), long (*const)(int) noexcept>);
+static_assert(equal<decltype(parallel_sequence<&A::f, &A::f>), int (*const)(A&, int)>);
+static_assert(equal<decltype(parallel_sequence<&m>), void (*const)(std::unique_ptr<int>)>);
+static_assert(parallel_sequence<&g> == &g);
+static_assert(parallel_sequence<&f, &g, &f> != sequence<&f, &g, &f>);
+
+static_assert(equal<decltype(parallel_batch<&f>), void (*const)(const int*, std::size_t)>);
+static_assert(equal<decltype(parallel_batch<&g>), void (*const)(const int*, int*, std::size_t)>);
+static_assert(
+    equal<decltype(parallel_batch<&h>), void (*const)(const int*, long*, std::size_t) noexcept>);
+static_assert(
+    equal<decltype(parallel_batch<&A::f>), void (*const)(A*, const int*, int*, std::size_t)>);
+static_assert(parallel_batch<&g> != batch<&g>);
+
+}  // namespace
+}  // namespace sfn
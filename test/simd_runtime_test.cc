@@ -0,0 +1,78 @@
+#include "test/check.h"
+#include <sfn/simd.h>
+#include <cstddef>
+
+namespace sfn {
+namespace {
+
+template <typename T>
+T scale(T x) {
+  return x * T(2);
+}
+template <typename T>
+T madd(const T& x, T y, T z) {
+  return x * y + z;
+}
+
+// 19 elements at width 8 runs the vector loop twice and leaves a scalar tail of 3.
+constexpr std::size_t kSize = 19;
+
+void test_unary() {
+  float in[kSize];
+  float out[kSize + 1];
+  for (std::size_t i = 0; i < kSize; ++i) {
+    in[i] = static_cast<float>(i);
+  }
+  out[kSize] = -1.f;
+  simd_map<&scale<float>, &scale<simd<float, 8>>>(in, out, kSize);
+  for (std::size_t i = 0; i < kSize; ++i) {
+    SFN_CHECK(out[i] == 2.f * static_cast<float>(i));
+  }
+  SFN_CHECK(out[kSize] == -1.f);
+}
+
+void test_bound() {
+  float y[kSize];
+  float z[kSize];
+  float out[kSize];
+  for (std::size_t i = 0; i < kSize; ++i) {
+    y[i] = static_cast<float>(i);
+    z[i] = 1.f;
+  }
+  simd_map<bind_front<&madd<float>, 3>, bind_front<&madd<simd<float, 8>>, 3>>(y, z, out, kSize);
+  for (std::size_t i = 0; i < kSize; ++i) {
+    SFN_CHECK(out[i] == 3.f * static_cast<float>(i) + 1.f);
+  }
+}
+
+void test_portable() {
+  double in[kSize];
+  double out[kSize];
+  for (std::size_t i = 0; i < kSize; ++i) {
+    in[i] = static_cast<double>(i) - 9.;
+  }
+  simd_map<&scale<double>, &scale<detail::portable_simd<double, 4>>>(in, out, kSize);
+  for (std::size_t i = 0; i < kSize; ++i) {
+    SFN_CHECK(out[i] == 2. * in[i]);
+  }
+}
+
+void test_short() {
+  float in[3] = {1.f, 2.f, 3.f};
+  float out[3] = {};
+  simd_map<&scale<float>, &scale<simd<float, 8>>>(in, out, 3);
+  SFN_CHECK(out[0] == 2.f && out[1] == 4.f && out[2] == 6.f);
+  simd_map<&scale<float>, &scale<simd<float, 8>>>(in, out, 0);
+  SFN_CHECK(out[0] == 2.f);
+}
+
+}  // namespace
+}  // namespace sfn
+
+int main() {
+  sfn::test_unary();
+  sfn::test_bound();
+  sfn::test_portable();
+  sfn::test_short();
+  return 0;
+}
@@ -0,0 +1,68 @@
+#include <sfn/simd.h>
+#include <cstddef>
+#include <type_traits>
+
+namespace sfn {
+namespace {
+
+template <typename T>
+T scale(T x) {
+  return x * T(2);
+}
+template <typename T>
+T add(T x, T y) {
+  return x + y;
+}
+template <typename T>
+T madd(const T& x, T y, T z) {
+  return x * y + z;
+}
+
+using f8 = simd<float, 8>;
+using f16 = simd<float, 16>;
+using i8 = simd<int, 8>;
+using p4 = detail::portable_simd<double, 4>;
+
+template <typename T, typename U>
+inline constexpr bool equal = std::is_same_v<T, U>;
+
+static_assert(simd_type<f8>);
+static_assert(simd_type<const f16&>);
+static_assert(simd_type<p4>);
+static_assert(!simd_type<float>);
+static_assert(f8::size() == 8);
+static_assert(p4::size() == 4);
+static_assert(p4(2.)[3] == 2.);
+static_assert((p4(2.) * p4(3.) + p4(1.))[0] == 7.);
+static_assert((-p4(2.))[1] == -2.);
+
+static_assert(simd_mappable<float(float), f8(f8)>);
+static_assert(simd_mappable<float(float), f16(f16)>);
+static_assert(simd_mappable<float(float, float), f8(f8, f8)>);
+static_assert(simd_mappable<float(const float&, float, float), f8(const f8&, f8, f8)>);
+static_assert(simd_mappable<double(double), p4(p4)>);
+static_assert(simd_mappable<decltype(&scale<float>), decltype(&scale<f8>)>);
+static_assert(!simd_mappable<float(float), float(float)>);
+static_assert(!simd_mappable<float(float), f8(float)>);
+static_assert(!simd_mappable<float(float), f8(f16)>);
+static_assert(!simd_mappable<float(float), i8(i8)>);
+static_assert(!simd_mappable<float(float), f8(f8, f8)>);
+static_assert(!simd_mappable<int(float), f8(f8)>);
+static_assert(!simd_mappable<void(float), f8(f8)>);
+
+static_assert(equal<function_type_of<decltype(simd_map<&scale<float>, &scale<f8>>)>,
+                    void(const float*, float*, std::size_t)>);
+static_assert(equal<function_type_of<decltype(simd_map<&add<float>, &add<f16>>)>,
+                    void(const float*, const float*, float*, std::size_t)>);
+static_assert(equal<function_type_of<decltype(simd_map<&scale<double>, &scale<p4>>)>,
+                    void(const double*, double*, std::size_t)>);
+static_assert(
+    equal<function_type_of<decltype(simd_map<compose<&scale<float>, bind_back<&add<float>, 3>>,
+                                             compose<&scale<f8>, bind_back<&add<f8>, 3>>>)>,
+          void(const float*, float*, std::size_t)>);
+static_assert(equal<function_type_of<decltype(simd_map<bind_front<&madd<float>, 2>,
+                                                       bind_front<&madd<f8>, 2>>)>,
+                    void(const float*, const float*, float*, std::size_t)>);
+
+}  // namespace
+}  // namespace sfn
@@ -0,0 +1,178 @@
+#include "test/check.h"
+#include <sfn/slot.h>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__)
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace sfn {
+namespace {
+
+struct Plugin {};
+struct Outer {};
+struct Empty {};
+using plugin = slot<int(int), Plugin>;
+using outer = slot<int(int), Outer>;
+
+// Number of calls currently running each version, which must be 0 once it has been retired.
+std::atomic<int> running[2];
+
+template <int Version>
+int plugin_v(int x) {
+  ++running[Version];
+  x += Version;
+  --running[Version];
+  return x;
+}
+
+void test_membarrier_mode() {
+#ifdef STATIC_FUNCTIONAL_SLOT_NO_MEMBARRIER
+  SFN_CHECK(!detail::slot_membarrier);
+#endif
+}
+
+void test_empty() {
+  using empty = slot<int(int), Empty>;
+  SFN_CHECK(empty::load() == nullptr);
+  bool threw = false;
+  try {
+    empty::call(1);
+  } catch (const std::bad_function_call&) {
+    threw = true;
+  }
+  SFN_CHECK(threw);
+  SFN_CHECK(empty::swap<&plugin_v<1>>().previous == nullptr);
+  SFN_CHECK(empty::call(1) == 2);
+  SFN_CHECK(empty::swap(nullptr).previous == &plugin_v<1>);
+  SFN_CHECK(empty::load() == nullptr);
+}
+
+#if defined(__unix__)
+void test_empty_noexcept_terminates() {
+  auto pid = fork();
+  SFN_CHECK(pid >= 0);
+  if (!pid) {
+    std::set_terminate([] { _exit(0); });
+    slot<int(int) noexcept, Empty>::call(1);
+    _exit(1);
+  }
+  int status = 0;
+  SFN_CHECK(waitpid(pid, &status, 0) == pid);
+  SFN_CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+}
+#endif
+
+void test_swap() {
+  SFN_CHECK(plugin::swap<&plugin_v<0>>().previous == nullptr);
+  SFN_CHECK(plugin::call(1) == 1);
+  auto retired = plugin::swap(&plugin_v<1>);
+  SFN_CHECK(retired.previous == &plugin_v<0>);
+  SFN_CHECK(retired.quiesced());
+  SFN_CHECK(plugin::load() == &plugin_v<1>);
+  SFN_CHECK(plugin::call(1) == 2);
+}
+
+slot_retired<int(int)> retired_inside;
+
+int swaps_inside(int x) {
+  retired_inside = plugin::swap<&plugin_v<0>>();
+  // This call is still running, inside two slot calls.
+  SFN_CHECK(!retired_inside.quiesced());
+  return x;
+}
+
+void test_nested() {
+  // The outer slot calls through the inner one, so the reader scopes nest.
+  SFN_CHECK(outer::swap<plugin::call>().previous == nullptr);
+  SFN_CHECK(plugin::swap<&swaps_inside>().previous == &plugin_v<1>);
+  SFN_CHECK(outer::call(3) == 3);
+  SFN_CHECK(retired_inside.previous == &swaps_inside);
+  SFN_CHECK(retired_inside.quiesced());
+  SFN_CHECK(detail::slot_local_reader->nesting == 0u);
+  SFN_CHECK(detail::slot_local_reader->active == 0u);
+  SFN_CHECK(outer::call(3) == 3);
+}
+
+std::atomic<bool> entered = false;
+std::atomic<bool> release = false;
+
+int blocks(int x) {
+  entered = true;
+  while (!release) {
+    std::this_thread::yield();
+  }
+  return x;
+}
+
+void test_wait_for_reader() {
+  (void)plugin::swap<&blocks>();
+  std::thread reader([] { SFN_CHECK(plugin::call(5) == 5); });
+  while (!entered) {
+    std::this_thread::yield();
+  }
+  auto retired = plugin::swap<&plugin_v<0>>();
+  SFN_CHECK(retired.previous == &blocks);
+  SFN_CHECK(!retired.quiesced());
+  // New calls already use the new target.
+  SFN_CHECK(plugin::call(5) == 5);
+  SFN_CHECK(!retired.quiesced());
+  release = true;
+  retired.wait();
+  SFN_CHECK(retired.quiesced());
+  reader.join();
+}
+
+void test_concurrent() {
+  (void)plugin::swap<&plugin_v<0>>();
+  constexpr int threads = 4;
+  std::atomic<int> started = 0;
+  std::atomic<bool> stop = false;
+  std::vector<std::thread> readers;
+  for (int t = 0; t < threads; ++t) {
+    readers.emplace_back([&started, &stop, t] {
+      for (int i = 0; !stop; ++i) {
+        // Half of the calls go through the outer slot, to nest the reader scopes.
+        int x = (i + t) % 2 ? plugin::call(i) : outer::call(i);
+        SFN_CHECK(x == i || x == i + 1);
+        if (!i) {
+          ++started;
+        }
+      }
+    });
+  }
+  while (started < threads) {
+    std::this_thread::yield();
+  }
+  for (int i = 1; i <= 50; ++i) {
+    auto retired = i % 2 ? plugin::swap<&plugin_v<1>>() : plugin::swap<&plugin_v<0>>();
+    retired.wait();
+    SFN_CHECK(running[(i + 1) % 2] == 0);
+    std::this_thread::yield();
+  }
+  stop = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+}
+
+}  // namespace
+}  // namespace sfn
+
+int main() {
+  sfn::test_membarrier_mode();
+  sfn::test_empty();
+#if defined(__unix__)
+  sfn::test_empty_noexcept_terminates();
+#endif
+  sfn::test_swap();
+  sfn::test_nested();
+  sfn::test_wait_for_reader();
+  sfn::test_concurrent();
+  return 0;
+}
@@ -0,0 +1,47 @@
+#include <sfn/slot.h>
+#include <type_traits>
+
+namespace sfn {
+namespace {
+
+template <typename T, typename U>
+inline constexpr bool equal = std::is_same_v<T, U>;
+
+struct Scoring {};
+struct Ranking {};
+
+int score_v1(int x) {
+  return x;
+}
+int score_v2(int x) noexcept {
+  return x + 1;
+}
+long score_long(short x) {
+  return x;
+}
+int score_pointer(int*) {
+  return 0;
+}
+
+template <typename Slot, auto F>
+concept swappable = requires { Slot::template swap<F>(); };
+
+using scoring = slot<int(int), Scoring>;
+using ranking = slot<int(int), Ranking>;
+using noexcept_scoring = slot<int(int) noexcept, Scoring>;
+
+static_assert(equal<decltype(scoring::call), int (*const)(int)>);
+static_assert(equal<decltype(noexcept_scoring::call), int (*const)(int) noexcept>);
+static_assert(scoring::call != ranking::call);
+static_assert(equal<decltype(scoring::load()), int (*)(int)>);
+static_assert(equal<decltype(scoring::swap(&score_v1)), slot_retired<int(int)>>);
+static_assert(equal<decltype(scoring::swap<&score_v2>()), slot_retired<int(int)>>);
+static_assert(swappable<scoring, &score_v1>);
+static_assert(swappable<scoring, &score_long>);
+static_assert(swappable<noexcept_scoring, &score_v1>);
+static_assert(!swappable<scoring, &score_pointer>);
+static_assert(noexcept(scoring::swap(nullptr)));
+static_assert(equal<decltype(slot_retired<int(int)>{}.quiesced()), bool>);
+
+}  // namespace
+}  // namespace sfn
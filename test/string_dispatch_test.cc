@@ -0,0 +1,109 @@
+#include <sfn/string_dispatch.h>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace sfn {
+namespace {
+
+template <typename T, typename U>
+inline constexpr bool equal = std::is_same_v<T, U>;
+
+struct Request {
+  int id = 0;
+};
+
+constexpr int get(const Request& request, int x) {
+  return request.id + x;
+}
+constexpr int put(const Request& request, int x) noexcept {
+  return request.id - x;
+}
+constexpr long erase(const Request&) noexcept {
+  return 3;
+}
+constexpr int noexcept_get(const Request&, int) noexcept {
+  return 4;
+}
+constexpr int not_found(std::string_view key, const Request&, int) noexcept {
+  return -static_cast<int>(key.size());
+}
+int not_found_string(const std::string&, const Request&, int) {
+  return 0;
+}
+int take_string(std::string, int) {
+  return 0;
+}
+int nothing() {
+  return 0;
+}
+
+static_assert(string_entry<entry<"get", &get>>);
+static_assert(!string_entry<int>);
+static_assert(equal<decltype(entry<"get", &get>::key), const std::string_view>);
+
+static_assert(string_dispatchable<entry<"get", &get>>);
+static_assert(string_dispatchable<entry<"get", &get>, entry<"put", &put>, entry<"erase", &erase>>);
+static_assert(!string_dispatchable<>);
+static_assert(!string_dispatchable<int>);
+static_assert(!string_dispatchable<entry<"get", &get>, entry<"get", &put>>);
+static_assert(!string_dispatchable<entry<"get", &get>, entry<"take", &take_string>>);
+static_assert(string_dispatchable<entry<"get", &get>, entry<"nothing", &nothing>>);
+static_assert(!string_dispatchable<entry<"nothing", &nothing>, entry<"get", &get>>);
+static_assert(string_dispatchable_or<decltype(&not_found), entry<"get", &get>>);
+static_assert(!string_dispatchable_or<decltype(&not_found_string), entry<"get", &get>>);
+static_assert(!string_dispatchable_or<decltype(&nothing), entry<"get", &get>>);
+static_assert(!string_dispatchable_or<decltype(&not_found)>);
+static_assert(
+    !string_dispatchable_or<decltype(&not_found), entry<"put", &put>, entry<"put", &get>>);
+
+static_assert(
+    equal<decltype(string_dispatch<entry<"get", &get>, entry<"put", &put>>),
+          int (*const)(std::string_view, const Request&, int)>);
+static_assert(equal<decltype(string_dispatch_or<&not_found, entry<"get", &get>>),
+                    int (*const)(std::string_view, const Request&, int)>);
+static_assert(
+    equal<decltype(string_dispatch_or<&not_found, entry<"put", &put>, entry<"get", &noexcept_get>>),
+          int (*const)(std::string_view, const Request&, int) noexcept>);
+
+constexpr auto handle = string_dispatch_or<&not_found, entry<"get", &get>, entry<"put", &put>,
+                                           entry<"erase", &erase>, entry<"", &noexcept_get>>;
+static_assert(handle("get", Request{10}, 1) == 11);
+static_assert(handle("put", Request{10}, 1) == 9);
+static_assert(handle("erase", Request{10}, 1) == 3);
+static_assert(handle("", Request{10}, 1) == 4);
+static_assert(handle("gets", Request{10}, 1) == -4);
+static_assert(handle("ge", Request{10}, 1) == -2);
+static_assert(string_dispatch<entry<"get", &get>>("get", Request{1}, 2) == 3);
+
+// Keys longer than a word, and keys differing only in their first, middle or last byte.
+constexpr auto long_keys =
+    string_dispatch_or<&not_found, entry<"subscribe_to_events", &get>, entry<"abcdef", &put>,
+                       entry<"xyz", &noexcept_get>>;
+static_assert(long_keys("subscribe_to_events", Request{10}, 1) == 11);
+static_assert(long_keys("subscribe_to_eventz", Request{10}, 1) == -19);
+static_assert(long_keys("subscribe_tp_events", Request{10}, 1) == -19);
+static_assert(long_keys("abcdef", Request{10}, 1) == 9);
+static_assert(long_keys("abdcef", Request{10}, 1) == -6);
+static_assert(long_keys("xyz", Request{10}, 1) == 4);
+static_assert(long_keys("xzz", Request{10}, 1) == -3);
+
+// Every key in a larger table maps to its own handler.
+template <std::size_t I>
+constexpr string_literal<4> key() {
+  const char s[] = {char('a' + I % 26u), char('a' + I / 26u % 26u), char('0' + I / 676u), '\0'};
+  return s;
+}
+template <std::size_t I>
+constexpr std::size_t index() {
+  return I;
+}
+template <std::size_t... Is>
+constexpr bool all_found(std::index_sequence<Is...>) {
+  constexpr auto f = string_dispatch<entry<key<Is>(), &index<Is>>...>;
+  return ((f(key<Is>().view()) == Is) && ...);
+}
+static_assert(all_found(std::make_index_sequence<300>{}));
+
+}  // namespace
+}  // namespace sfn
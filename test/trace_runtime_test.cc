@@ -0,0 +1,198 @@
+// A small buffer, so that dropping events on overflow is easy to test.
+#define STATIC_FUNCTIONAL_TRACE_BUFFER_EVENTS 16
+#include "test/check.h"
+#include <sfn/trace.h>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace sfn {
+namespace {
+
+struct event {
+  std::string name;
+  double ts = 0;
+  double dur = 0;
+  unsigned tid = 0;
+};
+
+struct parsed_trace {
+  std::vector<event> events;
+  unsigned long long dropped = 0;
+};
+
+// Parses exactly the format written by trace_collect(), keeping names in their escaped form.
+parsed_trace parse(const std::string& json) {
+  constexpr std::string_view prefix = "{\"traceEvents\":[";
+  constexpr std::string_view name_key = "{\"name\":\"";
+  constexpr std::string_view name_end = "\",\"ph\":\"X\"";
+  SFN_CHECK(json.starts_with(prefix));
+  parsed_trace result;
+  auto i = prefix.size();
+  while (json.compare(i, name_key.size(), name_key) == 0) {
+    i += name_key.size();
+    auto end = json.find(name_end, i);
+    SFN_CHECK(end != std::string::npos);
+    event e;
+    e.name = json.substr(i, end - i);
+    int length = 0;
+    SFN_CHECK(std::sscanf(json.c_str() + end,
+                          "\",\"ph\":\"X\",\"ts\":%lf,\"dur\":%lf,\"pid\":1,\"tid\":%u}%n", &e.ts,
+                          &e.dur, &e.tid, &length) == 3);
+    result.events.push_back(e);
+    i = end + static_cast<std::size_t>(length);
+    if (json[i] == ',') {
+      ++i;
+    }
+  }
+  int length = 0;
+  SFN_CHECK(std::sscanf(json.c_str() + i, "],\"otherData\":{\"dropped_events\":%llu}}%n",
+                        &result.dropped, &length) == 1);
+  SFN_CHECK(i + static_cast<std::size_t>(length) == json.size());
+  return result;
+}
+
+int leaf(int x) {
+  return x + 1;
+}
+constexpr auto traced_leaf = trace<&leaf, "leaf">;
+int outer(int x) {
+  std::this_thread::sleep_for(std::chrono::microseconds{100});
+  return traced_leaf(x) * 2;
+}
+constexpr auto traced_outer = trace<&outer, "outer">;
+
+void test_gating() {
+  traced_leaf(0);
+  trace_start();
+  traced_leaf(1);
+  trace_stop();
+  traced_leaf(2);
+  auto result = parse(trace_collect());
+  SFN_CHECK(result.events.size() == 1u);
+  SFN_CHECK(result.events[0].name == "leaf");
+  SFN_CHECK(result.dropped == 0u);
+  // Collecting removes the events.
+  SFN_CHECK(parse(trace_collect()).events.empty());
+}
+
+void test_nesting() {
+  trace_start();
+  SFN_CHECK(traced_outer(1) == 4);
+  trace_stop();
+  auto result = parse(trace_collect());
+  SFN_CHECK(result.events.size() == 2u);
+  // Events are recorded when they end, so the inner call comes first.
+  const auto& inner = result.events[0];
+  const auto& outer = result.events[1];
+  SFN_CHECK(inner.name == "leaf" && outer.name == "outer");
+  SFN_CHECK(inner.tid == outer.tid);
+  SFN_CHECK(outer.dur >= 100.);
+  SFN_CHECK(inner.ts >= outer.ts);
+  SFN_CHECK(inner.ts + inner.dur <= outer.ts + outer.dur);
+}
+
+void test_threads() {
+  trace_start();
+  traced_leaf(0);
+  std::thread{[] {
+    traced_leaf(1);
+    traced_leaf(2);
+  }}.join();
+  std::thread{[] { traced_leaf(3); }}.join();
+  trace_stop();
+  auto result = parse(trace_collect());
+  SFN_CHECK(result.events.size() == 4u);
+  std::vector<unsigned> tids;
+  for (const auto& e : result.events) {
+    SFN_CHECK(e.name == "leaf");
+    if (tids.empty() || tids.back() != e.tid) {
+      tids.push_back(e.tid);
+    }
+  }
+  // Each thread's events are contiguous, and each thread has its own tid.
+  SFN_CHECK(tids.size() == 3u);
+  SFN_CHECK(tids[0] != tids[1] && tids[1] != tids[2] && tids[0] != tids[2]);
+}
+
+std::size_t buffer_count() {
+  std::lock_guard lock{detail::trace_global.mutex};
+  std::size_t count = 0;
+  for (auto* b = detail::trace_global.buffers; b; b = b->next) {
+    ++count;
+  }
+  return count;
+}
+
+void test_buffer_reuse() {
+  // test_threads collected the events of its exited threads, which freed their buffers.
+  SFN_CHECK(buffer_count() == 1u);
+  trace_start();
+  detail::trace_buffer* first = nullptr;
+  std::thread{[&first] {
+    traced_leaf(0);
+    first = detail::trace_local_buffer();
+    // Drained while the thread is still running, so it's kept for reuse when the thread exits.
+    SFN_CHECK(parse(trace_collect()).events.size() == 1u);
+  }}.join();
+  SFN_CHECK(buffer_count() == 2u);
+  detail::trace_buffer* second = nullptr;
+  std::thread{[&second] {
+    traced_leaf(1);
+    second = detail::trace_local_buffer();
+  }}.join();
+  SFN_CHECK(second == first);
+  SFN_CHECK(buffer_count() == 2u);
+  // Buffers with events can't be reused until they're collected, which then frees them.
+  for (int i = 0; i < 3; ++i) {
+    std::thread{[] { traced_leaf(2); }}.join();
+  }
+  SFN_CHECK(buffer_count() == 5u);
+  trace_stop();
+  auto result = parse(trace_collect());
+  SFN_CHECK(result.events.size() == 4u);
+  // Each thread gets its own tid, even when it reuses a buffer.
+  SFN_CHECK(result.events[0].tid != result.events[1].tid);
+  SFN_CHECK(buffer_count() == 1u);
+}
+
+void nothing() {}
+
+void test_escaping() {
+  trace_start();
+  trace<&nothing, "a\"b\\c\nd\x01">();
+  trace_stop();
+  auto result = parse(trace_collect());
+  SFN_CHECK(result.events.size() == 1u);
+  SFN_CHECK(result.events[0].name == "a\\\"b\\\\c\\u000ad\\u0001");
+}
+
+void test_dropped() {
+  trace_start();
+  for (int i = 0; i < 20; ++i) {
+    traced_leaf(i);
+  }
+  trace_stop();
+  auto result = parse(trace_collect());
+  SFN_CHECK(result.events.size() == 16u);
+  SFN_CHECK(result.dropped == 4u);
+  SFN_CHECK(parse(trace_collect()).dropped == 0u);
+}
+
+}  // namespace
+}  // namespace sfn
+
+int main() {
+  sfn::test_gating();
+  sfn::test_nesting();
+  sfn::test_threads();
+  sfn::test_buffer_reuse();
+  sfn::test_escaping();
+  sfn::test_dropped();
+  return 0;
+}
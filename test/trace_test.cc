@@ -0,0 +1,38 @@
+#include <sfn/trace.h>
+#include <memory>
+#include <type_traits>
+
+namespace sfn {
+namespace {
+
+template <typename T, typename U>
+inline constexpr bool equal = std::is_same_v<T, U>;
+
+struct A {
+  int f(int x) const noexcept {
+    return x;
+  }
+};
+
+int f(int x) {
+  return x + 1;
+}
+int g(int x) {
+  return x * 2;
+}
+void v() {}
+std::unique_ptr<int> h(std::unique_ptr<int> p) {
+  return p;
+}
+
+static_assert(equal<decltype(trace<&f, "f">), int (*const)(int)>);
+static_assert(equal<decltype(trace<&v, "v">), void (*const)()>);
+static_assert(equal<decltype(trace<&h, "h">),
+                    std::unique_ptr<int> (*const)(std::unique_ptr<int>)>);
+static_assert(equal<decltype(trace<&A::f, "A::f">), int (*const)(const A&, int) noexcept>);
+static_assert(trace<&f, "f"> != trace<&f, "g">);
+static_assert(equal<decltype(trace<compose<&g, &f>, "gf">), int (*const)(int)>);
+static_assert(equal<decltype(compose<trace<&g, "g">, trace<&f, "f">>), int (*const)(int)>);
+
+}  // namespace
+}  // namespace sfn
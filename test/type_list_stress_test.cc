@@ -0,0 +1,87 @@
+#include <sfn/type_list.h>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+// Instantiates type_list operations on very long lists. None of these should require raising the
+// compiler's template instantiation depth limit.
+namespace sfn {
+namespace {
+
+template <std::size_t N>
+struct E {
+  E() = delete;
+};
+
+template <std::size_t... Ns>
+constexpr auto make_list_impl(std::index_sequence<Ns...>) -> list<E<Ns>...>;
+template <std::size_t N>
+using make_list = decltype(make_list_impl(std::make_index_sequence<N>{}));
+
+template <std::size_t Offset, std::size_t... Ns>
+constexpr auto make_range_impl(std::index_sequence<Ns...>) -> list<E<Offset + Ns>...>;
+template <std::size_t Begin, std::size_t End>
+using make_range = decltype(make_range_impl<Begin>(std::make_index_sequence<End - Begin>{}));
+
+template <typename T>
+struct is_even;
+template <std::size_t N>
+struct is_even<E<N>> : std::bool_constant<N % 2 == 0> {};
+template <typename T>
+struct is_last;
+template <std::size_t N>
+struct is_last<E<N>> : std::bool_constant<N == 2999> {};
+
+template <typename T>
+struct next;
+template <std::size_t N>
+struct next<E<N>> : std::type_identity<E<N + 1>> {};
+
+template <std::size_t... Ns>
+constexpr auto make_evens_impl(std::index_sequence<Ns...>) -> list<E<2 * Ns>...>;
+template <std::size_t N>
+using make_evens = decltype(make_evens_impl(std::make_index_sequence<N>{}));
+
+template <typename T, typename U>
+inline constexpr bool equal = std::is_same_v<T, U>;
+
+using list1000 = make_list<1000>;
+
+static_assert(size<list1000> == 1000);
+static_assert(equal<get<list1000, 0>, E<0>>);
+static_assert(equal<get<list1000, 500>, E<500>>);
+static_assert(equal<get<list1000, 999>, E<999>>);
+static_assert(equal<front<list1000>, E<0>>);
+static_assert(equal<back<list1000>, E<999>>);
+static_assert(equal<select<list1000, 999, 0, 998>, list<E<999>, E<0>, E<998>>>);
+
+static_assert(equal<sublist<list1000, 0>, list1000>);
+static_assert(equal<sublist<list1000, 1000>, list<>>);
+static_assert(equal<sublist<list1000, 1>, make_range<1, 1000>>);
+static_assert(equal<sublist<list1000, 999>, list<E<999>>>);
+static_assert(equal<sublist<list1000, 0, 999>, make_range<0, 999>>);
+static_assert(equal<sublist<list1000, 0, 32>, make_range<0, 32>>);
+static_assert(equal<sublist<list1000, 0, 64>, make_range<0, 64>>);
+static_assert(equal<sublist<list1000, 1, 65>, make_range<1, 66>>);
+static_assert(equal<sublist<list1000, 250, 500>, make_range<250, 750>>);
+static_assert(equal<sublist<list1000, 900, 500>, make_range<900, 1000>>);
+static_assert(equal<erase<list1000, 1, 998>, list<E<0>, E<999>>>);
+static_assert(equal<erase<list1000, 500>, make_range<0, 500>>);
+
+using list3000 = make_list<3000>;
+
+static_assert(equal<drop_back<list3000>, make_range<0, 2999>>);
+static_assert(equal<drop_front<list3000>, make_range<1, 3000>>);
+static_assert(equal<map<list3000, next>, make_range<1, 3001>>);
+static_assert(equal<filter<list3000, is_even>, make_evens<1500>>);
+static_assert(equal<filter<list3000, is_last>, list<E<2999>>>);
+static_assert(equal<remove_if<list3000, is_even>, map<make_evens<1500>, next>>);
+static_assert(find_if<list3000, is_last> == 2999);
+static_assert(find<list3000, E<2500>> == 2500);
+static_assert(find<list3000, E<3000>> == 3000);
+static_assert(count_if<list3000, is_even> == 1500);
+static_assert(any_of<list3000, is_last>);
+static_assert(!all_of<list3000, is_even>);
+
+}  // namespace
+}  // namespace sfn
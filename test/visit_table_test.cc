@@ -0,0 +1,93 @@
+#include <sfn/visit_table.h>
+#include <string>
+#include <type_traits>
+#include <variant>
+
+namespace sfn {
+namespace {
+
+template <typename T, typename U>
+inline constexpr bool equal = std::is_same_v<T, U>;
+
+struct Ping {
+  int id = 0;
+};
+struct Data {
+  std::string payload;
+};
+struct Close {};
+using Message = std::variant<Ping, Data, Close>;
+using Repeated = std::variant<Ping, Ping>;
+
+constexpr int on_ping(const Ping& ping, int x) {
+  return ping.id + x;
+}
+int on_data(Data& data, int x) {
+  return static_cast<int>(data.payload.size()) + x;
+}
+constexpr long on_close(Close, long x) noexcept {
+  return x;
+}
+constexpr int on_ping_noexcept(Ping, int) noexcept {
+  return 0;
+}
+constexpr int on_data_noexcept(const Data&, int) noexcept {
+  return 1;
+}
+constexpr int on_other(const Message& message, int) noexcept {
+  return 100 + static_cast<int>(message.index());
+}
+int on_string(std::string, int) {
+  return 0;
+}
+int on_nothing() {
+  return 0;
+}
+
+static_assert(variant<Message>);
+static_assert(variant<const Message>);
+static_assert(!variant<Ping>);
+static_assert(equal<variant_alternatives<Message>, list<Ping, Data, Close>>);
+static_assert(equal<variant_alternatives<const Message>, list<Ping, Data, Close>>);
+
+static_assert(visitable<Message, decltype(&on_ping), decltype(&on_data), decltype(&on_close)>);
+static_assert(visitable<Message, decltype(&on_close), decltype(&on_ping), decltype(&on_data)>);
+static_assert(!visitable<Message, decltype(&on_ping), decltype(&on_data)>);
+static_assert(!visitable<Message, decltype(&on_ping), decltype(&on_ping_noexcept),
+                         decltype(&on_data), decltype(&on_close)>);
+static_assert(!visitable<Message, decltype(&on_ping), decltype(&on_data), decltype(&on_close),
+                         decltype(&on_string)>);
+static_assert(!visitable<const Message, decltype(&on_ping), decltype(&on_data),
+                         decltype(&on_close)>);
+static_assert(!visitable<Message, decltype(&on_nothing)>);
+static_assert(!visitable<Repeated, decltype(&on_ping)>);
+static_assert(!visitable<Ping, decltype(&on_ping)>);
+static_assert(visitable_or<Message, decltype(&on_other)>);
+static_assert(visitable_or<Message, decltype(&on_other), decltype(&on_data)>);
+static_assert(visitable_or<const Message, decltype(&on_other), decltype(&on_ping)>);
+static_assert(!visitable_or<const Message, decltype(&on_other), decltype(&on_data)>);
+static_assert(!visitable_or<Message, decltype(&on_ping)>);
+
+static_assert(equal<decltype(visit_table<Message, &on_ping, &on_data, &on_close>),
+                    int (*const)(Message&, int)>);
+static_assert(equal<decltype(visit_table<const Message, &on_close, &on_ping_noexcept,
+                                         &on_data_noexcept>),
+                    long (*const)(const Message&, long)>);
+static_assert(equal<decltype(visit_table_or<Message, &on_other, &on_ping_noexcept>),
+                    int (*const)(Message&, int) noexcept>);
+static_assert(equal<decltype(visit_table_or<const Message, &on_other, &on_ping, &on_data_noexcept>),
+                    int (*const)(const Message&, int)>);
+
+constexpr int visit_ping(int id, int x) {
+  Message message = Ping{id};
+  return visit_table<Message, &on_ping, &on_data, &on_close>(message, x);
+}
+constexpr int visit_close_or(int x) {
+  const Message message = Close{};
+  return visit_table_or<const Message, &on_other, &on_ping>(message, x);
+}
+static_assert(visit_ping(3, 4) == 7);
+static_assert(visit_close_or(4) == 102);
+
+}  // namespace
+}  // namespace sfn